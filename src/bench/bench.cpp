@@ -0,0 +1,294 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"allocation.hpp"
+#include"checkpoint.hpp"
+#include"common.hpp"
+#include"eventlog.hpp"
+#include"generator.hpp"
+#include"histogram.hpp"
+#include"metrics.hpp"
+#include"msystem.hpp"
+#include"options.hpp"
+#include"parameters.hpp"
+#include"simulation.hpp"
+#include"trace.hpp"
+#include<algorithm>
+#include<array>
+#include<chrono>
+#include<cstdlib>
+#include<exception>
+#include<iostream>
+#include<memory>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+namespace {
+
+enum ParameterIndex : size_t {
+    HOURS,
+    DOUGH,
+    FILLING,
+    PICKER,
+    COURIERS,
+    GRID,
+    RATE,
+    PROFILE,
+    LATE,
+    STEP,
+    SEED,
+    WARMUP,
+    CHECK,
+    TRACE,
+    SPANS,
+    METRICS,
+    RECORD,
+    CHECKPOINT,
+    RESTORE,
+    NUMBER_OF_PARAMETERS
+};
+
+struct BenchResult {
+    double                                      wallTime_;      // seconds
+    unsigned long long int                      updates_;
+    size_t                                      ordersCreated_;
+    size_t                                      ordersCompleted_;
+    size_t                                      peakRSS_;       // kilobytes
+    unsigned long long int                      allocations_;   // during the updates of the system
+    unsigned long long int                      steadyAllocations_; // after the warm-up, in the updates without arrivals and route searches
+    cmn::Histogram                              latency_;       // of the completed orders, ticks
+    std::array<cmn::Histogram, cmn::numberOf<ds::OrderPhase>()> phaseLatency_; // ticks
+};
+
+constexpr double percentiles[]{ 50.0, 90.0, 99.0, 99.9 };
+
+std::string getCheckpointName(unsigned long long int row)
+{
+    return u8"pizza-ds-bench-" + std::to_string(row) + u8".checkpoint";
+}
+
+// the trace, the metrics, the events and the checkpoint of the run are written to files
+// numbered by the row of the results
+BenchResult run(const std::vector<unsigned long long int>& config, size_t row)
+{
+    using namespace std::chrono;
+
+    ds::OptionsSimulation options{};
+    options.optGenerator_.orderRate_ = int(config[RATE]);
+    options.optGenerator_.profile_ = int(config[PROFILE]);
+    options.optDelivery_.lateInsertion_ = config[LATE] > 0;
+
+    bench::Simulation simulation{ size_t(config[GRID]), options };
+    ds::ManagmentSystem& ms{ simulation.ms_ };
+
+    // the run is repeated exactly with the same seed
+    cmn::seedRandomNumbers(static_cast<unsigned int>(config[SEED]));
+    std::unique_ptr<ds::EventLog> eventLog{};
+    if (config[RECORD] > 0 && config[RESTORE] == 0) {
+        eventLog = std::make_unique<ds::EventLog>(u8"pizza-ds-bench-" + std::to_string(row) + u8".events");
+        ms.setEventLog(eventLog.get());
+    }
+
+    ds::OrderGenerator generator{ ms, config[SEED] };
+    if (config[RESTORE] > 0) {
+        // the workers and the map are those of the checkpoint, the random numbers go on from it
+        const auto start{ steady_clock::now() };
+        if (ds::Checkpoint::restore(ms, getCheckpointName(config[RESTORE])) == false) {
+            throw std::runtime_error{ u8"can not restore " + getCheckpointName(config[RESTORE]) };
+        }
+        generator.setTime(ms.getCurrentTick());
+        std::cerr << u8"restored " << ms.orderTable().size() << u8" orders in "
+            << duration_cast<duration<double, std::milli>>(steady_clock::now() - start).count()
+            << u8" ms" << std::endl;
+    }
+    else {
+        bench::staff(ms, config[DOUGH], config[FILLING], config[PICKER], config[COURIERS]);
+    }
+
+    cmn::Tracer& tracer{ cmn::Tracer::instance() };
+    if (config[TRACE] > 0) {
+        tracer.start(size_t(config[TRACE]), size_t(config[SPANS]));
+    }
+
+    // the exporter is destroyed before the system, its last snapshot is written then
+    std::unique_ptr<ds::MetricsExporter> exporter{};
+    if (config[METRICS] > 0) {
+        exporter = std::make_unique<ds::MetricsExporter>(ms,
+            u8"pizza-ds-bench-" + std::to_string(row) + u8".prom", milliseconds{ config[METRICS] });
+    }
+
+    BenchResult result{};
+    const nanoseconds step{ milliseconds{ config[STEP] } };
+    const nanoseconds simulatedTime{ hours{ config[HOURS] } };
+    const nanoseconds warmupTime{ hours{ config[WARMUP] } };
+    auto writeCheckpoint{ [&ms, row]() {
+        if (ds::Checkpoint::write(ms, getCheckpointName(row)) == false) {
+            std::cerr << u8"can not write " << getCheckpointName(row) << std::endl;
+        }
+    } };
+    if (config[CHECKPOINT] > 0 && warmupTime == nanoseconds{ 0 }) {
+        writeCheckpoint();
+    }
+    const auto start{ steady_clock::now() };
+    for (nanoseconds time{ 0 }; time < simulatedTime; time += step) {
+        generator.update(step);
+        // the arrival and the routing of orders may allocate, other updates must not
+        const size_t orders{ ms.orderTable().size() };
+        const unsigned long long int searches{ simulation.map_->getNumberOfSearches() };
+        const unsigned long long int routed{ simulation.delivery_.getNumberOfRoutedOrders() };
+        ms.update(step);
+        if (exporter != nullptr) {
+            exporter->update();
+        }
+        ++result.updates_;
+        result.allocations_ += ms.getAllocations();
+        if (config[CHECKPOINT] > 0 && time < warmupTime && time + step >= warmupTime) {
+            writeCheckpoint();
+        }
+        if (time >= warmupTime
+            && orders == ms.orderTable().size()
+            && searches == simulation.map_->getNumberOfSearches()
+            && routed == simulation.delivery_.getNumberOfRoutedOrders())
+        {
+            result.steadyAllocations_ += ms.getAllocations();
+        }
+    }
+    result.wallTime_ = duration_cast<duration<double>>(steady_clock::now() - start).count();
+    if (exporter != nullptr) {
+        exporter->publish();
+    }
+    if (eventLog != nullptr) {
+        ms.setEventLog(nullptr);
+        if (eventLog->finish(ms) == false) {
+            std::cerr << u8"can not write the events of the row " << row << std::endl;
+        }
+    }
+    result.ordersCreated_ = ms.orderTable().size();
+    result.ordersCompleted_ = ms.orderTable().countStatus(ds::OrderStatus::COMPLETED);
+    result.peakRSS_ = bench::getPeakRSS();
+    result.latency_ = simulation.scheduler_.getTotalLatency();
+    for (char i = 0; i < cmn::numberOf<ds::OrderPhase>(); ++i) {
+        result.phaseLatency_[i] = simulation.scheduler_.getLatency(ds::OrderPhase{ i });
+    }
+    if (config[TRACE] > 0) {
+        tracer.stop();
+        const std::string fileName{ u8"pizza-ds-bench-" + std::to_string(row) + u8".trace.json" };
+        if (tracer.write(fileName) == false) {
+            std::cerr << u8"can not write " << fileName << std::endl;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    using namespace std;
+
+    try {
+        vector<bench::Parameter> parameters(NUMBER_OF_PARAMETERS);
+        parameters[HOURS]       = { u8"hours",      u8"simulated hours",                            { 1 } };
+        parameters[DOUGH]       = { u8"dough",      u8"number of dough kitcheners",                 { 2 } };
+        parameters[FILLING]     = { u8"filling",    u8"number of filling kitcheners",               { 3 } };
+        parameters[PICKER]      = { u8"picker",     u8"number of picker kitcheners",                { 4 } };
+        parameters[COURIERS]    = { u8"couriers",   u8"number of couriers",                         { 3 } };
+        parameters[GRID]        = { u8"grid",       u8"side of the square grid map, 0 - default map", { 0 } };
+        parameters[RATE]        = { u8"rate",       u8"orders per hour",                            { 15 } };
+        parameters[PROFILE]     = { u8"profile",    u8"0 - Poisson, 1 - diurnal, 2 - burst",        { 0 } };
+        parameters[LATE]        = { u8"late",       u8"1 - insert the orders into the routes being accepted", { 0 } };
+        parameters[STEP]        = { u8"step",       u8"simulation step, milliseconds",              { 16 } };
+        parameters[SEED]        = { u8"seed",       u8"seed of the order generator and the workers", { 1 } };
+        parameters[WARMUP]      = { u8"warmup",     u8"simulated hours before the steady state",    { 1 } };
+        parameters[CHECK]       = { u8"check",      u8"1 - fail on allocations in the steady state, route searches excluded", { 0 } };
+        parameters[TRACE]       = { u8"trace",      u8"traced transitions kept, 0 - no trace",      { 0 } };
+        parameters[SPANS]       = { u8"spans",      u8"traced spans kept, 0 - no spans",            { 0 } };
+        parameters[METRICS]     = { u8"metrics",    u8"period of the metrics file, milliseconds, 0 - no file", { 0 } };
+        parameters[RECORD]      = { u8"record",     u8"1 - record the events for the replay, not after a restore", { 0 } };
+        parameters[CHECKPOINT]  = { u8"checkpoint", u8"1 - write the state at the end of the warm-up", { 0 } };
+        parameters[RESTORE]     = { u8"restore",    u8"row of the checkpoint to start from, 0 - empty start", { 0 } };
+
+        if (bench::parseArguments(argc, argv, parameters) == false
+            || bench::checkRange(parameters[HOURS], 1, 24 * 365) == false
+            || bench::checkRange(parameters[RATE],
+                ds::OptionsGenerator::minOrderRate_, ds::OptionsGenerator::maxOrderRate_) == false
+            || bench::checkRange(parameters[PROFILE], 0, cmn::numberOf<ds::ArrivalProfile>() - 1) == false
+            || bench::checkRange(parameters[LATE], 0, 1) == false
+            || bench::checkRange(parameters[STEP], 1, 60 * 60 * 1000) == false
+            || bench::checkRange(parameters[WARMUP], 0, 24 * 365) == false
+            || bench::checkRange(parameters[CHECK], 0, 1) == false
+            || bench::checkRange(parameters[TRACE], 0, 1ull << 30) == false
+            || bench::checkRange(parameters[SPANS], 0, 1ull << 30) == false
+            || bench::checkRange(parameters[METRICS], 0, ds::MetricsExporter::maxPeriod_.count()) == false
+            || bench::checkRange(parameters[RECORD], 0, 1) == false
+            || bench::checkRange(parameters[CHECKPOINT], 0, 1) == false)
+        {
+            bench::printUsage(u8"pizza-ds-bench", parameters);
+            return EXIT_FAILURE;
+        }
+        const bool isChecked{
+            std::find(parameters[CHECK].values_.cbegin(), parameters[CHECK].values_.cend(), 1)
+                != parameters[CHECK].values_.cend()
+        };
+        if (isChecked && cmn::isAllocationCounted == false) {
+            cerr << u8"the allocation check needs a build with DS_COUNT_ALLOCATIONS" << endl;
+            return EXIT_FAILURE;
+        }
+
+        // the peak RSS is of the whole process, so the runs are better ordered from small to large;
+        // a row is printed whole after its run, so the messages of the first run precede the header
+        // and those of the other runs go between the rows
+        vector<size_t> indexes(NUMBER_OF_PARAMETERS, 0);
+        vector<unsigned long long int> config{};
+        bool isFailed{ false };
+        size_t row{ 0 };
+        do {
+            bench::selectCombination(parameters, indexes, config);
+            const BenchResult result{ run(config, ++row) };
+            if (row == 1) {
+                bench::printHeader(parameters,
+                    u8"wall_s,wall_s_per_sim_hour,updates_per_s,orders_created,orders_completed,peak_rss_kb,"
+                    u8"allocs_per_update,steady_allocs,p50_s,p90_s,p99_s,p999_s,"
+                    u8"queue_p99_s,cooking_p99_s,waiting_p99_s,driving_p99_s");
+            }
+            bench::printCombination(config);
+            cout << result.wallTime_ << ','
+                << result.wallTime_ / config[HOURS] << ','
+                << result.updates_ / result.wallTime_ << ','
+                << result.ordersCreated_ << ','
+                << result.ordersCompleted_ << ','
+                << result.peakRSS_ << ','
+                << double(result.allocations_) / result.updates_ << ','
+                << result.steadyAllocations_;
+            auto getSeconds{ [](const cmn::Histogram& histogram, double percentile) {
+                return double(histogram.getPercentile(percentile)) / cmn::ticksPerSecond;
+            } };
+            for (const double percentile : percentiles) {
+                cout << ',' << getSeconds(result.latency_, percentile);
+            }
+            for (const auto& histogram : result.phaseLatency_) {
+                cout << ',' << getSeconds(histogram, 99.0);
+            }
+            cout << endl;
+            if (config[CHECK] == 1 && result.steadyAllocations_ > 0) {
+                isFailed = true;
+            }
+        } while (bench::nextCombination(parameters, indexes));
+        if (isFailed) {
+            cerr << u8"the steady state allocates" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception& e) {
+        cerr << e.what() << endl;
+        exit(EXIT_FAILURE);
+    }
+    catch (...) {
+        cerr << u8"[Unknown exception]" << endl;
+        exit(EXIT_FAILURE);
+    }
+    return 0;
+}
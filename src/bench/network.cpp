@@ -0,0 +1,178 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"common.hpp"
+#include"histogram.hpp"
+#include"map.hpp"
+#include"msystem.hpp"
+#include"network.hpp"
+#include"options.hpp"
+#include"parameters.hpp"
+#include"scheduler.hpp"
+#include"simulation.hpp"
+#include<algorithm>
+#include<chrono>
+#include<cstdlib>
+#include<exception>
+#include<iostream>
+#include<limits>
+#include<random>
+#include<vector>
+
+namespace {
+
+enum ParameterIndex : size_t {
+    HOURS,
+    OFFICES,
+    SELECTION,
+    DOUGH,
+    FILLING,
+    PICKER,
+    COURIERS,
+    GRID,
+    RATE,
+    STEP,
+    SEED,
+    NUMBER_OF_PARAMETERS
+};
+
+struct NetworkResult {
+    double                                      wallTime_;      // seconds
+    unsigned long long int                      updates_;
+    size_t                                      ordersCreated_;
+    size_t                                      ordersCompleted_;
+    size_t                                      minOfficeOrders_;
+    size_t                                      maxOfficeOrders_;
+    cmn::Histogram                              latency_;       // of the completed orders of all offices, ticks
+};
+
+constexpr double percentiles[]{ 50.0, 90.0, 99.0 };
+
+// the offices are spread evenly over the middle row of the grid
+std::vector<ds::Graph::vertex_descriptor> placeOffices(size_t grid, size_t numOffices)
+{
+    std::vector<ds::Graph::vertex_descriptor> offices{};
+    for (size_t i = 0; i < numOffices; ++i) {
+        offices.push_back(grid / 2 * grid + (2 * i + 1) * grid / (2 * numOffices));
+    }
+    return offices;
+}
+
+// the workers of the offices other than the first one draw their random numbers on their own threads,
+// so only the arrivals are repeated exactly with the same seed
+NetworkResult run(const std::vector<unsigned long long int>& config)
+{
+    using namespace std::chrono;
+
+    cmn::seedRandomNumbers(static_cast<unsigned int>(config[SEED]));
+    const size_t grid{ size_t(config[GRID]) };
+    ds::Map map{ grid, grid, bench::gridSpacing };
+    ds::OfficeNetwork network{ map, placeOffices(grid, size_t(config[OFFICES])), ds::OptionsSimulation{} };
+    network.setSelection(static_cast<ds::OfficeSelection>(config[SELECTION]));
+
+    // every office has the same staff
+    for (size_t o = 0; o < network.getNumberOfOffices(); ++o) {
+        bench::staff(network.office(o), config[DOUGH], config[FILLING], config[PICKER], config[COURIERS]);
+    }
+
+    // Poisson arrivals over the whole city, every order is routed to an office by the network
+    std::mt19937_64 engine{ config[SEED] };
+    std::exponential_distribution<double> interval{ double(config[RATE]) / 3600.0 };
+    auto getInterval{ [&engine, &interval]() {
+        return duration_cast<nanoseconds>(duration<double>{ interval(engine) });
+    } };
+
+    NetworkResult result{};
+    const nanoseconds step{ milliseconds{ config[STEP] } };
+    const nanoseconds simulatedTime{ hours{ config[HOURS] } };
+    nanoseconds nextArrival{ getInterval() };
+    const auto start{ steady_clock::now() };
+    for (nanoseconds time{ 0 }; time < simulatedTime; time += step) {
+        for (; nextArrival <= time + step; nextArrival += getInterval()) {
+            network.createOrder();
+        }
+        network.update(step);
+        ++result.updates_;
+    }
+    result.wallTime_ = duration_cast<duration<double>>(steady_clock::now() - start).count();
+    result.minOfficeOrders_ = std::numeric_limits<size_t>::max();
+    for (size_t o = 0; o < network.getNumberOfOffices(); ++o) {
+        const ds::ManagmentSystem& ms{ network.office(o) };
+        const size_t orders{ ms.orderTable().size() };
+        result.ordersCreated_ += orders;
+        result.ordersCompleted_ += ms.orderTable().countStatus(ds::OrderStatus::COMPLETED);
+        result.minOfficeOrders_ = std::min(result.minOfficeOrders_, orders);
+        result.maxOfficeOrders_ = std::max(result.maxOfficeOrders_, orders);
+        result.latency_.merge(ms.scheduler().getTotalLatency());
+    }
+    return result;
+}
+
+} // namespace
+
+// Throughput of the office network: the offices share the map and are updated on their own threads
+int main(int argc, char* argv[])
+{
+    using namespace std;
+
+    try {
+        vector<bench::Parameter> parameters(NUMBER_OF_PARAMETERS);
+        parameters[HOURS]       = { u8"hours",      u8"simulated hours",                            { 1 } };
+        parameters[OFFICES]     = { u8"offices",    u8"number of offices, at most the side of the grid", { 4 } };
+        parameters[SELECTION]   = { u8"selection",  u8"0 - nearest office, 1 - least loaded office", { 0 } };
+        parameters[DOUGH]       = { u8"dough",      u8"number of dough kitcheners of an office",    { 2 } };
+        parameters[FILLING]     = { u8"filling",    u8"number of filling kitcheners of an office",  { 3 } };
+        parameters[PICKER]      = { u8"picker",     u8"number of picker kitcheners of an office",   { 4 } };
+        parameters[COURIERS]    = { u8"couriers",   u8"number of couriers of an office",            { 3 } };
+        parameters[GRID]        = { u8"grid",       u8"side of the square grid map",                { 10 } };
+        parameters[RATE]        = { u8"rate",       u8"orders per hour of the whole network",       { 60 } };
+        parameters[STEP]        = { u8"step",       u8"simulation step, milliseconds",              { 16 } };
+        parameters[SEED]        = { u8"seed",       u8"seed of the arrivals",                       { 1 } };
+
+        if (bench::parseArguments(argc, argv, parameters) == false
+            || bench::checkRange(parameters[HOURS], 1, 24 * 365) == false
+            || bench::checkRange(parameters[OFFICES], 1, 1024) == false
+            || bench::checkRange(parameters[SELECTION], 0, cmn::numberOf<ds::OfficeSelection>() - 1) == false
+            || bench::checkRange(parameters[GRID], 2, 1000) == false
+            || bench::checkRange(parameters[RATE], 1, 100'000) == false
+            || bench::checkRange(parameters[STEP], 1, 60 * 60 * 1000) == false
+            || bench::checkRange(parameters[SEED], 0, numeric_limits<unsigned int>::max()) == false
+            || *max_element(parameters[OFFICES].values_.cbegin(), parameters[OFFICES].values_.cend())
+                > *min_element(parameters[GRID].values_.cbegin(), parameters[GRID].values_.cend()))
+        {
+            bench::printUsage(u8"pizza-ds-network-bench", parameters);
+            return EXIT_FAILURE;
+        }
+
+        bench::printHeader(parameters,
+            u8"wall_s,updates_per_s,orders_created,orders_completed,"
+            u8"min_office_orders,max_office_orders,p50_s,p90_s,p99_s");
+        vector<size_t> indexes(NUMBER_OF_PARAMETERS, 0);
+        vector<unsigned long long int> config{};
+        do {
+            bench::getCombination(parameters, indexes, config);
+            const NetworkResult result{ run(config) };
+            cout << result.wallTime_ << ','
+                << result.updates_ / result.wallTime_ << ','
+                << result.ordersCreated_ << ','
+                << result.ordersCompleted_ << ','
+                << result.minOfficeOrders_ << ','
+                << result.maxOfficeOrders_;
+            for (const double percentile : percentiles) {
+                cout << ',' << double(result.latency_.getPercentile(percentile)) / cmn::ticksPerSecond;
+            }
+            cout << endl;
+        } while (bench::nextCombination(parameters, indexes));
+    }
+    catch (const std::exception& e) {
+        cerr << e.what() << endl;
+        exit(EXIT_FAILURE);
+    }
+    catch (...) {
+        cerr << u8"[Unknown exception]" << endl;
+        exit(EXIT_FAILURE);
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef PARAMETERS_HPP
+#define PARAMETERS_HPP
+
+#include<cstdlib>
+#include<iostream>
+#include<sstream>
+#include<string>
+#include<vector>
+#ifdef _WIN32
+#define NOMINMAX
+#include<windows.h>
+#include<psapi.h>
+#else
+#include<sys/resource.h>
+#endif
+
+namespace bench {
+
+// every parameter takes a comma-separated list of values, all combinations are run
+struct Parameter {
+    const char*                                 name_;
+    const char*                                 description_;
+    std::vector<unsigned long long int>         values_;
+};
+
+// peak resident set size of the process, kilobytes
+inline size_t getPeakRSS()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) == FALSE) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize / 1024;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return size_t(usage.ru_maxrss) / 1024;
+#else
+    return size_t(usage.ru_maxrss);
+#endif
+#endif
+}
+
+inline void printUsage(const char* name, const std::vector<Parameter>& parameters)
+{
+    std::cerr << u8"usage: " << name << u8" [name=value[,value...]]..." << std::endl;
+    for (const auto& parameter : parameters) {
+        std::cerr << u8"  " << parameter.name_ << u8" - " << parameter.description_
+            << u8" (default " << parameter.values_.front() << u8')' << std::endl;
+    }
+}
+
+inline bool parseArgument(const std::string& argument, std::vector<Parameter>& parameters)
+{
+    const size_t equal{ argument.find('=') };
+    if (equal == std::string::npos) {
+        return false;
+    }
+    const std::string name{ argument.substr(0, equal) };
+    for (auto& parameter : parameters) {
+        if (name != parameter.name_) {
+            continue;
+        }
+        parameter.values_.clear();
+        std::istringstream iss{ argument.substr(equal + 1) };
+        std::string value;
+        while (std::getline(iss, value, ',')) {
+            char* end{ nullptr };
+            parameter.values_.push_back(std::strtoull(value.c_str(), &end, 10));
+            if (value.empty() || *end != '\0') {
+                return false;
+            }
+        }
+        return parameter.values_.empty() == false;
+    }
+    return false;
+}
+
+inline bool parseArguments(int argc, char* argv[], std::vector<Parameter>& parameters)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (parseArgument(argv[i], parameters) == false) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// all values of the parameter are within the range
+inline bool checkRange(const Parameter& parameter, unsigned long long int min, unsigned long long int max)
+{
+    for (const auto value : parameter.values_) {
+        if (value < min || value > max) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void printHeader(const std::vector<Parameter>& parameters, const char* results)
+{
+    for (const auto& parameter : parameters) {
+        std::cout << parameter.name_ << ',';
+    }
+    std::cout << results << std::endl;
+}
+
+// selects the values of the current combination
+inline void selectCombination(const std::vector<Parameter>& parameters, const std::vector<size_t>& indexes,
+                              std::vector<unsigned long long int>& config)
+{
+    config.resize(parameters.size());
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        config[i] = parameters[i].values_[indexes[i]];
+    }
+}
+
+inline void printCombination(const std::vector<unsigned long long int>& config)
+{
+    for (const auto value : config) {
+        std::cout << value << ',';
+    }
+}
+
+// selects the values of the current combination and prints them
+inline void getCombination(const std::vector<Parameter>& parameters, const std::vector<size_t>& indexes,
+                           std::vector<unsigned long long int>& config)
+{
+    selectCombination(parameters, indexes, config);
+    printCombination(config);
+}
+
+// moves to the next combination, the last parameter changes first, returns false after the last one
+inline bool nextCombination(const std::vector<Parameter>& parameters, std::vector<size_t>& indexes)
+{
+    size_t i{ parameters.size() };
+    while (i > 0 && ++indexes[i - 1] == parameters[i - 1].values_.size()) {
+        indexes[--i] = 0;
+    }
+    return i > 0;
+}
+
+} // namespace bench
+
+#endif // !PARAMETERS_HPP
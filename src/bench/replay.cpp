@@ -0,0 +1,72 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"common.hpp"
+#include"eventlog.hpp"
+#include"parameters.hpp"
+#include<cstdlib>
+#include<exception>
+#include<iomanip>
+#include<iostream>
+#include<limits>
+#include<string>
+
+// Replays the event logs as fast as possible and checks the hashes of their final states;
+// the searches stopped by the time budget depend on the machine, so a log with them may differ
+int main(int argc, char* argv[])
+{
+    using namespace std;
+
+    try {
+        if (argc < 2) {
+            cerr << u8"usage: pizza-ds-replay file..." << endl;
+            return EXIT_FAILURE;
+        }
+        cout << u8"file,events,updates,orders,sim_hours,wall_s,sim_hours_per_wall_s,"
+            u8"hash,recorded_hash,match,divergent_order,timeouts,recorded_timeouts,peak_rss_kb" << endl;
+        bool isFailed{ false };
+        for (int i = 1; i < argc; ++i) {
+            ds::ReplayResult result{};
+            if (ds::replayEventLog(argv[i], result) == false) {
+                cerr << argv[i] << u8": " << result.error_ << endl;
+                isFailed = true;
+                continue;
+            }
+            const double simHours{ double(result.tick_) / cmn::ticksPerSecond / 3600.0 };
+            // a log without the end has no hash to compare with
+            const bool isMatched{ result.isComplete_ == false || result.hash_ == result.recordedHash_ };
+            cout << argv[i] << ','
+                << result.events_ << ','
+                << result.updates_ << ','
+                << result.orders_ << ','
+                << simHours << ','
+                << result.wallTime_ << ','
+                << (result.wallTime_ > 0.0 ? simHours / result.wallTime_ : 0.0) << ','
+                << hex << setw(16) << setfill('0') << result.hash_ << ','
+                << setw(16) << result.recordedHash_ << dec << setfill(' ') << ','
+                << (result.isComplete_ ? (isMatched ? u8"yes" : u8"no") : u8"incomplete") << ','
+                << (result.divergentOrder_ == numeric_limits<size_t>::max() ? string{ u8"-" }
+                                                                          : to_string(result.divergentOrder_)) << ','
+                << result.timeouts_ << ','
+                << result.recordedTimeouts_ << ','
+                << bench::getPeakRSS() << endl;
+            if (isMatched == false || result.divergentOrder_ != numeric_limits<size_t>::max()) {
+                isFailed = true;
+            }
+        }
+        if (isFailed) {
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception& e) {
+        cerr << e.what() << endl;
+        exit(EXIT_FAILURE);
+    }
+    catch (...) {
+        cerr << u8"[Unknown exception]" << endl;
+        exit(EXIT_FAILURE);
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"map.hpp"
+#include"options.hpp"
+#include"parameters.hpp"
+#include<algorithm>
+#include<chrono>
+#include<cstdlib>
+#include<exception>
+#include<iostream>
+#include<random>
+#include<vector>
+
+namespace {
+
+enum ParameterIndex : size_t {
+    GRID,
+    QUEUE,
+    LABELS,
+    TIME,
+    REPEATS,
+    SEED,
+    NUMBER_OF_PARAMETERS
+};
+
+struct RoutingResult {
+    double                                      meanLatency_;   // milliseconds
+    double                                      maxLatency_;    // milliseconds
+    double                                      meanLabels_;
+    size_t                                      maxLabelBytes_;
+    double                                      meanVisited_;   // routed orders
+    size_t                                      incomplete_;    // searches stopped by the budget
+};
+
+constexpr int gridSpacing{ 20 };                // pixels
+
+// the queue of the delivery, the deadlines are random within the delivery time
+std::vector<ds::MapTarget> makeTargets(size_t numVertices, size_t office, size_t queue,
+                                       int deliveryTime, std::mt19937_64& engine)
+{
+    std::uniform_int_distribution<size_t> selectVertex{ 0, numVertices - 2 };
+    std::uniform_int_distribution<int> selectDeadline{ deliveryTime / 2, deliveryTime };
+    std::vector<ds::MapTarget> targets(queue);
+    for (auto& target : targets) {
+        const size_t vertex{ selectVertex(engine) };
+        target.vertex_ = vertex >= office ? vertex + 1 : vertex;
+        target.deadline_ = selectDeadline(engine);
+    }
+    // the sorted queue is a valid min-heap on the deadline
+    std::sort(targets.begin(), targets.end(), [](const ds::MapTarget& t1, const ds::MapTarget& t2) {
+        return t1.deadline_ < t2.deadline_;
+    });
+    return targets;
+}
+
+RoutingResult run(const std::vector<unsigned long long int>& config)
+{
+    using namespace std::chrono;
+
+    ds::OptionsSimulation options{};
+    options.optDelivery_.maxRouteLabels_ = int(config[LABELS]);
+    options.optDelivery_.maxRouteTime_ = int(config[TIME]);
+
+    const size_t grid{ size_t(config[GRID]) };
+    const ds::Map map{ grid, grid, gridSpacing };
+    const size_t office{ grid / 2 * grid + grid / 2 };
+    std::mt19937_64 engine{ config[SEED] };
+
+    RoutingResult result{};
+    for (unsigned long long int i = 0; i < config[REPEATS]; ++i) {
+        const auto targets{ makeTargets(grid * grid, office, size_t(config[QUEUE]),
+            options.optDelivery_.deliveryTime_, engine) };
+        const auto start{ steady_clock::now() };
+        const ds::MapPath mp{ map.getPath(office, targets, 0, options) };
+        const double latency{ duration_cast<duration<double, std::milli>>(steady_clock::now() - start).count() };
+        result.meanLatency_ += latency;
+        result.maxLatency_ = std::max(result.maxLatency_, latency);
+        result.meanLabels_ += double(mp.labels_);
+        result.maxLabelBytes_ = std::max(result.maxLabelBytes_, mp.labelBytes_);
+        result.meanVisited_ += double(mp.visited_.size());
+        result.incomplete_ += mp.complete_ ? 0 : 1;
+    }
+    result.meanLatency_ /= double(config[REPEATS]);
+    result.meanLabels_ /= double(config[REPEATS]);
+    result.meanVisited_ /= double(config[REPEATS]);
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    using namespace std;
+
+    try {
+        vector<bench::Parameter> parameters(NUMBER_OF_PARAMETERS);
+        parameters[GRID]        = { u8"grid",       u8"side of the square grid map",            { 4, 8, 16 } };
+        parameters[QUEUE]       = { u8"queue",      u8"number of waiting orders",               { 1, 2, 4, 8, 16, 32, 64 } };
+        parameters[LABELS]      = { u8"labels",     u8"budget of the search, labels",
+                                    { ds::OptionsDelivery::defMaxRouteLabels_ } };
+        parameters[TIME]        = { u8"time",       u8"budget of the search, milliseconds, 0 - none",
+                                    { ds::OptionsDelivery::defMaxRouteTime_ } };
+        parameters[REPEATS]     = { u8"repeats",    u8"searches with random queues per row",   { 10 } };
+        parameters[SEED]        = { u8"seed",       u8"seed of the random queues",              { 1 } };
+
+        if (bench::parseArguments(argc, argv, parameters) == false
+            || bench::checkRange(parameters[GRID], 2, 1000) == false
+            || bench::checkRange(parameters[QUEUE], 1, 1000) == false
+            || bench::checkRange(parameters[LABELS],
+                ds::OptionsDelivery::minMaxRouteLabels_, ds::OptionsDelivery::maxMaxRouteLabels_) == false
+            || bench::checkRange(parameters[TIME],
+                ds::OptionsDelivery::minMaxRouteTime_, ds::OptionsDelivery::maxMaxRouteTime_) == false
+            || bench::checkRange(parameters[REPEATS], 1, 1000000) == false)
+        {
+            bench::printUsage(u8"pizza-ds-routing-bench", parameters);
+            return EXIT_FAILURE;
+        }
+
+        bench::printHeader(parameters,
+            u8"mean_ms,max_ms,mean_labels,max_label_bytes,mean_routed,incomplete,peak_rss_kb");
+        vector<size_t> indexes(NUMBER_OF_PARAMETERS, 0);
+        vector<unsigned long long int> config{};
+        do {
+            bench::getCombination(parameters, indexes, config);
+            const RoutingResult result{ run(config) };
+            cout << result.meanLatency_ << ','
+                << result.maxLatency_ << ','
+                << result.meanLabels_ << ','
+                << result.maxLabelBytes_ << ','
+                << result.meanVisited_ << ','
+                << result.incomplete_ << ','
+                << bench::getPeakRSS() << endl;
+        } while (bench::nextCombination(parameters, indexes));
+    }
+    catch (const std::exception& e) {
+        cerr << e.what() << endl;
+        exit(EXIT_FAILURE);
+    }
+    catch (...) {
+        cerr << u8"[Unknown exception]" << endl;
+        exit(EXIT_FAILURE);
+    }
+    return 0;
+}
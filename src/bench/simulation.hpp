@@ -0,0 +1,71 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include"delivery.hpp"
+#include"kitchen.hpp"
+#include"map.hpp"
+#include"msystem.hpp"
+#include"options.hpp"
+#include"scheduler.hpp"
+#include<memory>
+#include<utility>
+
+namespace bench {
+
+constexpr int gridSpacing{ 20 };                // pixels
+
+// System of a single office with its own map, the office is in the middle of the grid
+struct Simulation {
+    // the default map if 'grid' is 0
+    Simulation(size_t grid, const ds::OptionsSimulation& options)
+        :
+        map_        { grid == 0 ? std::make_unique<ds::Map>()
+                                : std::make_unique<ds::Map>(grid, grid, gridSpacing) },
+        scheduler_  { grid / 2 * grid + grid / 2 },
+        kitchen_    {},
+        delivery_   {},
+        ms_         { *map_, scheduler_, kitchen_, delivery_, options }
+    {
+        scheduler_.setManagmentSystem(&ms_);
+        kitchen_.setManagmentSystem(&ms_);
+        delivery_.setManagmentSystem(&ms_);
+    }
+
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    const std::unique_ptr<ds::Map>              map_;
+    ds::Scheduler                               scheduler_;
+    ds::Kitchen                                 kitchen_;
+    ds::Delivery                                delivery_;
+    ds::ManagmentSystem                         ms_;
+};
+
+// the kitcheners and then the couriers are numbered from 0
+inline void staff(ds::ManagmentSystem& ms, unsigned long long int dough, unsigned long long int filling,
+                  unsigned long long int picker, unsigned long long int couriers)
+{
+    unsigned int id{ 0 };
+    const std::pair<ds::KitchenerType, unsigned long long int> kitcheners[]{
+        { ds::KitchenerType::DOUGH, dough },
+        { ds::KitchenerType::FILLING, filling },
+        { ds::KitchenerType::PICKER, picker },
+    };
+    for (const auto& [type, number] : kitcheners) {
+        for (unsigned long long int i = 0; i < number; ++i) {
+            ms.activateKitchener(ds::WorkerID{ id++ }, type);
+        }
+    }
+    for (unsigned long long int i = 0; i < couriers; ++i) {
+        ms.activateCourier(ds::WorkerID{ id++ });
+    }
+}
+
+} // namespace bench
+
+#endif // !SIMULATION_HPP
@@ -0,0 +1,257 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"common.hpp"
+#include"generator.hpp"
+#include"histogram.hpp"
+#include"msystem.hpp"
+#include"options.hpp"
+#include"parameters.hpp"
+#include"simulation.hpp"
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<cstdlib>
+#include<exception>
+#include<iostream>
+#include<limits>
+#include<memory>
+#include<mutex>
+#include<string>
+#include<thread>
+#include<vector>
+
+namespace {
+
+enum ParameterIndex : size_t {
+    HOURS,
+    DOUGH,
+    FILLING,
+    PICKER,
+    COURIERS,
+    GRID,
+    RATE,
+    PROFILE,
+    DELIVERY,
+    SPEED,
+    STEP,
+    NUMBER_OF_PARAMETERS
+};
+
+// the settings of the sweep are not combined
+enum SettingIndex : size_t {
+    RUNS,
+    SEED,
+    THREADS,
+    NUMBER_OF_SETTINGS
+};
+
+struct RunResult {
+    double                                      wallTime_;      // seconds
+    size_t                                      ordersCreated_;
+    size_t                                      ordersCompleted_;
+    unsigned long long int                      p95_;           // of the completed orders, ticks
+};
+
+// the results of all runs of a combination
+struct Aggregate {
+    std::mutex                                  mutex_;
+    cmn::Histogram                              latency_;       // of the completed orders of all runs, ticks
+};
+
+constexpr double percentiles[]{ 50.0, 95.0, 99.0 };
+
+// the run has its own options and random numbers, so it does not depend on the other runs on the thread
+RunResult run(const std::vector<unsigned long long int>& config, unsigned int seed, Aggregate& aggregate)
+{
+    using namespace std::chrono;
+
+    ds::OptionsSimulation options{};
+    options.optGenerator_.orderRate_ = int(config[RATE]);
+    options.optGenerator_.profile_ = int(config[PROFILE]);
+    options.optDelivery_.deliveryTime_ = int(config[DELIVERY] * 60);
+    options.optCourier_.averageSpeed_ = int(config[SPEED]);
+    cmn::seedRandomNumbers(seed);
+
+    bench::Simulation simulation{ size_t(config[GRID]), options };
+    ds::ManagmentSystem& ms{ simulation.ms_ };
+    bench::staff(ms, config[DOUGH], config[FILLING], config[PICKER], config[COURIERS]);
+    ds::OrderGenerator generator{ ms, seed };
+
+    const nanoseconds step{ milliseconds{ config[STEP] } };
+    const nanoseconds simulatedTime{ hours{ config[HOURS] } };
+    const auto start{ steady_clock::now() };
+    for (nanoseconds time{ 0 }; time < simulatedTime; time += step) {
+        generator.update(step);
+        ms.update(step);
+    }
+    RunResult result{};
+    result.wallTime_ = duration_cast<duration<double>>(steady_clock::now() - start).count();
+    result.ordersCreated_ = ms.orderTable().size();
+    result.ordersCompleted_ = ms.orderTable().countStatus(ds::OrderStatus::COMPLETED);
+    result.p95_ = simulation.scheduler_.getTotalLatency().getPercentile(95.0);
+    const std::lock_guard<std::mutex> lock{ aggregate.mutex_ };
+    aggregate.latency_.merge(simulation.scheduler_.getTotalLatency());
+    return result;
+}
+
+} // namespace
+
+// Monte Carlo sweep: every combination of the parameters is run with several seeds,
+// the runs are independent and spread over the threads, the results are aggregated
+// by the combination. The runs of all combinations share the seeds, so the combinations
+// are compared on the same arrivals.
+int main(int argc, char* argv[])
+{
+    using namespace std;
+
+    try {
+        vector<bench::Parameter> parameters(NUMBER_OF_PARAMETERS);
+        parameters[HOURS]       = { u8"hours",      u8"simulated hours",                            { 4 } };
+        parameters[DOUGH]       = { u8"dough",      u8"number of dough kitcheners",                 { 2 } };
+        parameters[FILLING]     = { u8"filling",    u8"number of filling kitcheners",               { 3 } };
+        parameters[PICKER]      = { u8"picker",     u8"number of picker kitcheners",                { 4 } };
+        parameters[COURIERS]    = { u8"couriers",   u8"number of couriers",                         { 3 } };
+        parameters[GRID]        = { u8"grid",       u8"side of the square grid map, 0 - default map", { 0 } };
+        parameters[RATE]        = { u8"rate",       u8"orders per hour",                            { 15 } };
+        parameters[PROFILE]     = { u8"profile",    u8"0 - Poisson, 1 - diurnal, 2 - burst",        { 0 } };
+        parameters[DELIVERY]    = { u8"delivery",   u8"promised delivery time, minutes",
+            { ds::OptionsDelivery::defDeliveryTime_ / 60 } };
+        parameters[SPEED]       = { u8"speed",      u8"average speed of the couriers, meters per second",
+            { ds::OptionsCourier::defAverageSpeed_ } };
+        parameters[STEP]        = { u8"step",       u8"simulation step, milliseconds",              { 1000 } };
+        vector<bench::Parameter> settings(NUMBER_OF_SETTINGS);
+        settings[RUNS]          = { u8"runs",       u8"runs of every combination",                  { 20 } };
+        settings[SEED]          = { u8"seed",       u8"seed of the first run, the next runs take the next seeds", { 1 } };
+        settings[THREADS]       = { u8"threads",    u8"threads running the simulations, 0 - all cores", { 0 } };
+
+        bool isParsed{ true };
+        for (int i = 1; i < argc && isParsed; ++i) {
+            isParsed = bench::parseArgument(argv[i], parameters) || bench::parseArgument(argv[i], settings);
+        }
+        for (auto& setting : settings) {
+            isParsed = isParsed && setting.values_.size() == 1;
+        }
+        if (isParsed == false
+            || bench::checkRange(parameters[HOURS], 1, 24 * 365) == false
+            || bench::checkRange(parameters[RATE],
+                ds::OptionsGenerator::minOrderRate_, ds::OptionsGenerator::maxOrderRate_) == false
+            || bench::checkRange(parameters[PROFILE], 0, cmn::numberOf<ds::ArrivalProfile>() - 1) == false
+            || bench::checkRange(parameters[DELIVERY],
+                ds::OptionsDelivery::minDeliveryTime_ / 60, ds::OptionsDelivery::maxDeliveryTime_ / 60) == false
+            || bench::checkRange(parameters[SPEED],
+                ds::OptionsCourier::minAverageSpeed_, ds::OptionsCourier::maxAverageSpeed_) == false
+            || bench::checkRange(parameters[STEP], 1, 60 * 60 * 1000) == false
+            || bench::checkRange(settings[RUNS], 1, 1'000'000) == false
+            || bench::checkRange(settings[SEED], 0, numeric_limits<unsigned int>::max()) == false
+            || bench::checkRange(settings[THREADS], 0, 1024) == false)
+        {
+            bench::printUsage(u8"pizza-ds-sweep", parameters);
+            for (const auto& setting : settings) {
+                cerr << u8"  " << setting.name_ << u8" - " << setting.description_
+                    << u8" (default " << setting.values_.front() << u8", single value)" << endl;
+            }
+            return EXIT_FAILURE;
+        }
+        const size_t runs{ size_t(settings[RUNS].values_.front()) };
+        const unsigned long long int seed{ settings[SEED].values_.front() };
+
+        // all combinations are listed first, their rows are printed in this order
+        vector<vector<unsigned long long int>> configs{};
+        vector<size_t> indexes(NUMBER_OF_PARAMETERS, 0);
+        do {
+            vector<unsigned long long int> config(NUMBER_OF_PARAMETERS);
+            for (size_t i = 0; i < NUMBER_OF_PARAMETERS; ++i) {
+                config[i] = parameters[i].values_[indexes[i]];
+            }
+            configs.push_back(std::move(config));
+        } while (bench::nextCombination(parameters, indexes));
+
+        const size_t numJobs{ configs.size() * runs };
+        size_t numThreads{ size_t(settings[THREADS].values_.front()) };
+        if (numThreads == 0) {
+            numThreads = std::max(1u, thread::hardware_concurrency());
+        }
+        numThreads = std::min(numThreads, numJobs);
+
+        vector<RunResult> results(numJobs);
+        vector<Aggregate> aggregates(configs.size());
+        atomic<size_t> nextJob{ 0 };
+        mutex errorMutex{};
+        exception_ptr error{};
+        auto work{ [&]() {
+            for (size_t job = nextJob++; job < numJobs; job = nextJob++) {
+                try {
+                    const size_t c{ job / runs };
+                    results[job] = run(configs[c], static_cast<unsigned int>(seed + job % runs), aggregates[c]);
+                }
+                catch (...) {
+                    const lock_guard<mutex> lock{ errorMutex };
+                    if (error == nullptr) {
+                        error = current_exception();
+                    }
+                    nextJob = numJobs;
+                }
+            }
+        } };
+        const auto start{ chrono::steady_clock::now() };
+        vector<thread> threads{};
+        for (size_t i = 1; i < numThreads; ++i) {
+            threads.emplace_back(work);
+        }
+        work();
+        for (auto& t : threads) {
+            t.join();
+        }
+        if (error != nullptr) {
+            rethrow_exception(error);
+        }
+        const double wallTime{ chrono::duration<double>(chrono::steady_clock::now() - start).count() };
+
+        bench::printHeader(parameters,
+            u8"runs,orders_created_mean,orders_completed_mean,p50_s,p95_s,p99_s,"
+            u8"run_p95_mean_s,run_p95_max_s,on_time_runs,run_wall_s_mean");
+        auto toSeconds{ [](unsigned long long int ticks) { return double(ticks) / cmn::ticksPerSecond; } };
+        for (size_t c = 0; c < configs.size(); ++c) {
+            double created{ 0.0 };
+            double completed{ 0.0 };
+            double p95{ 0.0 };
+            unsigned long long int p95Max{ 0 };
+            size_t onTime{ 0 };
+            double runWallTime{ 0.0 };
+            const cmn::tick_t promised{ cmn::tick_t(configs[c][DELIVERY]) * 60 * cmn::ticksPerSecond };
+            for (size_t r = 0; r < runs; ++r) {
+                const RunResult& result{ results[c * runs + r] };
+                created += double(result.ordersCreated_);
+                completed += double(result.ordersCompleted_);
+                p95 += toSeconds(result.p95_);
+                p95Max = std::max(p95Max, result.p95_);
+                onTime += result.p95_ <= static_cast<unsigned long long int>(promised) ? 1 : 0;
+                runWallTime += result.wallTime_;
+            }
+            for (const auto value : configs[c]) {
+                cout << value << ',';
+            }
+            cout << runs << ',' << created / runs << ',' << completed / runs;
+            for (const double percentile : percentiles) {
+                cout << ',' << toSeconds(aggregates[c].latency_.getPercentile(percentile));
+            }
+            cout << ',' << p95 / runs
+                << ',' << toSeconds(p95Max)
+                << ',' << double(onTime) / runs
+                << ',' << runWallTime / runs << endl;
+        }
+        cerr << numJobs << u8" runs on " << numThreads << u8" threads in " << wallTime << u8" s" << endl;
+    }
+    catch (const std::exception& e) {
+        cerr << e.what() << endl;
+        exit(EXIT_FAILURE);
+    }
+    catch (...) {
+        cerr << u8"[Unknown exception]" << endl;
+        exit(EXIT_FAILURE);
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"allocation.hpp"
+#include<cstdlib>
+#include<new>
+
+namespace cmn {
+
+namespace {
+
+// constant-initialized, so counting needs no allocation on a new thread
+thread_local unsigned long long int allocationCount{ 0 };
+
+} // namespace
+
+unsigned long long int getAllocationCount() noexcept
+{
+    return allocationCount;
+}
+
+} // namespace cmn
+
+#ifdef DS_COUNT_ALLOCATIONS
+
+// the replaced operators are linked together with 'getAllocationCount',
+// the other forms of new and delete call these ones
+void* operator new(std::size_t size)
+{
+    ++cmn::allocationCount;
+    void* p{ std::malloc(size == 0 ? 1 : size) };
+    if (p == nullptr) {
+        throw std::bad_alloc{};
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+#endif // DS_COUNT_ALLOCATIONS
@@ -0,0 +1,24 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef ALLOCATION_HPP
+#define ALLOCATION_HPP
+
+namespace cmn {
+
+// the global allocations are counted only in the builds with DS_COUNT_ALLOCATIONS
+#ifdef DS_COUNT_ALLOCATIONS
+constexpr bool isAllocationCounted{ true };
+#else
+constexpr bool isAllocationCounted{ false };
+#endif
+
+// number of calls of the global operator new on the calling thread since its start,
+// so the simulations updated on other threads are not counted; over-aligned allocations are not counted
+unsigned long long int getAllocationCount() noexcept;
+
+} // namespace cmn
+
+#endif // !ALLOCATION_HPP
@@ -5,40 +5,61 @@
 // (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
 
 #include"common.hpp"
-#include<ctime>
-#include<iomanip>
-#include<sstream>
+#include<cstdint>
+#include<limits>
 
 namespace cmn {
 
 using namespace std;
 
+namespace {
+
+// Every thread has its own engine, so simulations can be updated in parallel.
+// The engine and the mapping to a range are fixed by the standard and by the code below,
+// unlike 'default_random_engine' and 'uniform_int_distribution', so a seed gives the same
+// numbers with every compiler and a log written on one platform is replayed on another.
+thread_local unsigned int randomSeed{ random_device{}() };
+thread_local mt19937 randomEngine{ randomSeed };
+
+uint32_t drawRandom() noexcept
+{
+    return static_cast<uint32_t>(randomEngine());
+}
+
+} // namespace
+
 int getRandomNumber(int from, int to)
 {
-    static random_device rd;
-    static default_random_engine re{ rd() };
-    uniform_int_distribution<int> unifDist{ from, to };
-    return unifDist(re);
+    assert(from <= to);
+    // the values below 'threshold' are rejected, so every remainder is equally likely
+    const uint32_t range{ static_cast<uint32_t>(static_cast<uint32_t>(to) - static_cast<uint32_t>(from) + 1u) };
+    if (range == 0) {
+        return static_cast<int>(static_cast<long long int>(drawRandom()) + numeric_limits<int>::min());
+    }
+    const uint32_t threshold{ static_cast<uint32_t>(0u - range) % range };
+    uint32_t value{ drawRandom() };
+    while (value < threshold) {
+        value = drawRandom();
+    }
+    return static_cast<int>(static_cast<long long int>(from) + value % range);
+}
+
+void seedRandomNumbers(unsigned int seed)
+{
+    randomSeed = seed;
+    randomEngine.seed(seed);
 }
 
-string getDuration(chrono::system_clock::duration duration)
+unsigned int getRandomSeed() noexcept
 {
-    const auto hours  { chrono::duration_cast<chrono::hours>(duration) };
-    const auto minutes{ chrono::duration_cast<chrono::minutes>(duration) };
-    const auto seconds{ chrono::duration_cast<chrono::seconds>(duration) };
-    ostringstream oss;
-    oss << hours.count() << ':'
-        << setw(2) << setfill('0') << minutes.count() % 60 << ':'
-        << setw(2) << setfill('0') << seconds.count() % 60;
-    return oss.str();
+    return randomSeed;
 }
 
-string getTime(chrono::system_clock::time_point timePoint)
+unsigned int reseedRandomNumbers()
 {
-    const time_t t{ chrono::system_clock::to_time_t(timePoint) };
-    ostringstream oss;
-    oss << ctime(&t);
-    return oss.str();
+    const unsigned int seed{ drawRandom() };
+    seedRandomNumbers(seed);
+    return seed;
 }
 
 } // namespace cmn
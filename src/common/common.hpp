@@ -7,8 +7,11 @@
 #ifndef COMMON_HPP
 #define COMMON_HPP
 
+#include<algorithm>
 #include<assert.h>
 #include<chrono>
+#include<cmath>
+#include<limits>
 #include<random>
 #include<string>
 #include<type_traits>
@@ -70,11 +73,76 @@ constexpr auto lastEnum() noexcept
 
 ///************************************************************************************************
 
+// simulation clock, the time is counted in integer ticks since the start of the simulation
+using tick_t = long long int;
+
+constexpr tick_t ticksPerSecond{ 1'000'000'000 };
+
+constexpr tick_t maxTick{ std::numeric_limits<tick_t>::max() };
+
+static_assert(std::nano::den == ticksPerSecond);
+
+constexpr tick_t toTicks(std::chrono::nanoseconds duration) noexcept { return duration.count(); }
+
+constexpr std::chrono::nanoseconds toDuration(tick_t ticks) noexcept
+{
+    return std::chrono::nanoseconds{ ticks };
+}
+
+///************************************************************************************************
+
+// uniform in [from, to], the numbers after the same seed are the same on every platform
 int getRandomNumber(int from, int to);
 
-std::string getDuration(std::chrono::system_clock::duration duration);
+// Uniform in [0, range) from the values of a 32-bit or a 64-bit engine, e.g. 'std::mt19937_64'.
+// The distributions of the standard library differ between its implementations,
+// so the same engine gives the same numbers on every platform only through these functions.
+template <class Engine>
+unsigned long long int getRandomIndex(Engine& engine, unsigned long long int range)
+{
+    static_assert(Engine::min() == 0 && (Engine::max() == 0xFFFF'FFFFull || Engine::max() == ~0ull));
+    assert(range > 0 && range - 1 <= Engine::max());
+    // the values below 'threshold' are rejected, so every remainder is equally likely
+    const unsigned long long int threshold{ (Engine::max() - range + 1) % range };
+    unsigned long long int value{ engine() };
+    while (value < threshold) {
+        value = engine();
+    }
+    return value % range;
+}
+
+// uniform in [0, 1) with 53 random bits
+template <class Engine>
+double getRandomReal(Engine& engine)
+{
+    static_assert(Engine::min() == 0 && (Engine::max() == 0xFFFF'FFFFull || Engine::max() == ~0ull));
+    if constexpr (Engine::max() == 0xFFFF'FFFFull) {
+        const unsigned long long int high{ static_cast<unsigned long long int>(engine()) >> 5 };
+        const unsigned long long int low{ static_cast<unsigned long long int>(engine()) >> 6 };
+        return double((high << 26) | low) * 0x1.0p-53;
+    }
+    else {
+        return double(static_cast<unsigned long long int>(engine()) >> 11) * 0x1.0p-53;
+    }
+}
+
+// exponentially distributed with the mean of 1 / rate
+template <class Engine>
+double getRandomExponential(Engine& engine, double rate)
+{
+    assert(rate > 0.0);
+    return -std::log(1.0 - getRandomReal(engine)) / rate;
+}
 
-std::string getTime(std::chrono::system_clock::time_point timePoint);
+// the numbers of the thread are repeated after the same seed
+void seedRandomNumbers(unsigned int seed);
+
+// the last seed of the numbers of the thread
+unsigned int getRandomSeed() noexcept;
+
+// the numbers of the thread go on from a seed drawn from them, which is returned;
+// the seed alone is the state of the numbers, so it is saved and restored in a constant time
+unsigned int reseedRandomNumbers();
 
 template <class T>
 T extractWithShift(std::vector<T>& v, size_t index)
@@ -100,6 +168,16 @@ size_t getQtyOfValues(const std::vector<T>& container, const T& value)
     return qty;
 }
 
+// makes room for at least 'size' elements, the capacity grows geometrically as by 'push_back',
+// so reserving for every new element does not reallocate every time
+template <class T>
+void reserveGrowing(std::vector<T>& v, size_t size)
+{
+    if (size > v.capacity()) {
+        v.reserve(std::max(size, v.capacity() * 2));
+    }
+}
+
 } // namespace cmn
 
 #endif // !COMMON_HPP
@@ -0,0 +1,40 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"format.hpp"
+#include<ctime>
+
+namespace cmn {
+
+using namespace std;
+
+char* writeDuration(char* first, char* last, chrono::system_clock::duration duration) noexcept
+{
+    const auto hours  { chrono::duration_cast<chrono::hours>(duration) };
+    const auto minutes{ chrono::duration_cast<chrono::minutes>(duration) };
+    const auto seconds{ chrono::duration_cast<chrono::seconds>(duration) };
+    first = writeNumber(first, last, hours.count());
+    first = writeText(first, last, u8":");
+    first = writeNumber(first, last, minutes.count() % 60, 2, '0');
+    first = writeText(first, last, u8":");
+    return writeNumber(first, last, seconds.count() % 60, 2, '0');
+}
+
+char* writeTime(char* first, char* last, chrono::system_clock::time_point timePoint) noexcept
+{
+    // the same text as of 'ctime' without its static buffer and the line break
+    const time_t t{ chrono::system_clock::to_time_t(timePoint) };
+    tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &t);
+#else
+    localtime_r(&t, &local);
+#endif
+    char text[32];
+    const size_t length{ strftime(text, sizeof(text), u8"%a %b %e %H:%M:%S %Y", &local) };
+    return writeText(first, last, string_view{ text, length });
+}
+
+} // namespace cmn
@@ -0,0 +1,121 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef FORMAT_HPP
+#define FORMAT_HPP
+
+#include<algorithm>
+#include<array>
+#include<assert.h>
+#include<charconv>
+#include<chrono>
+#include<iterator>
+#include<string_view>
+#include<system_error>
+#include<type_traits>
+
+namespace cmn {
+
+// The text is written to [first, last) as by std::to_chars and is not terminated,
+// the functions return the end of the written text; the text that does not fit is cut.
+
+inline char* writeText(char* first, char* last, std::string_view text) noexcept
+{
+    const size_t length{ std::min(text.size(), size_t(last - first)) };
+    return std::copy_n(text.data(), length, first);
+}
+
+// the number is padded to 'width' with 'filler' on the left
+template <class Number>
+char* writeNumber(char* first, char* last, Number value, size_t width = 0, char filler = ' ') noexcept
+{
+    static_assert(std::is_arithmetic_v<Number> && std::is_same_v<Number, bool> == false);
+    char digits[32];                            // a double in the shortest form takes 24
+    const auto result{ std::to_chars(std::begin(digits), std::end(digits), value) };
+    assert(result.ec == std::errc{});
+    const size_t length(result.ptr - digits);
+    for (size_t i = length; i < width && first != last; ++i) {
+        *first++ = filler;
+    }
+    return writeText(first, last, std::string_view{ digits, length });
+}
+
+// "h:mm:ss", the hours are not limited
+char* writeDuration(char* first, char* last, std::chrono::system_clock::duration duration) noexcept;
+
+// local time as "Www Mmm dd hh:mm:ss yyyy"
+char* writeTime(char* first, char* last, std::chrono::system_clock::time_point timePoint) noexcept;
+
+///************************************************************************************************
+
+// Text formatted into a fixed buffer without allocations. The buffer lives on the stack
+// of the caller or is reused for every row of a list, so drawing a frame allocates nothing.
+// The text that does not fit is cut, the buffer is always terminated.
+template <size_t Capacity>
+class TextBuffer {
+public:
+    static_assert(Capacity > 1);
+
+public:
+    TextBuffer() noexcept
+        :
+        text_           {},
+        size_           { 0 }
+    {}
+
+    TextBuffer(const TextBuffer&) = delete;
+    TextBuffer& operator=(const TextBuffer&) = delete;
+
+public:
+    const char* c_str() const noexcept { return text_.data(); }
+
+    std::string_view view() const noexcept { return std::string_view{ text_.data(), size_ }; }
+
+    size_t size() const noexcept { return size_; }
+
+    TextBuffer& clear() noexcept { return setEnd(text_.data()); }
+
+    TextBuffer& append(std::string_view text) noexcept { return setEnd(writeText(getEnd(), getLast(), text)); }
+
+    TextBuffer& append(char c) noexcept { return append(std::string_view{ &c, 1 }); }
+
+    // the number is padded to 'width' with 'filler' on the left
+    template <class Number, std::enable_if_t<std::is_arithmetic_v<Number>, int> = 0>
+    TextBuffer& append(Number value, size_t width = 0, char filler = ' ') noexcept
+    {
+        return setEnd(writeNumber(getEnd(), getLast(), value, width, filler));
+    }
+
+    TextBuffer& appendDuration(std::chrono::system_clock::duration duration) noexcept
+    {
+        return setEnd(writeDuration(getEnd(), getLast(), duration));
+    }
+
+    TextBuffer& appendTime(std::chrono::system_clock::time_point timePoint) noexcept
+    {
+        return setEnd(writeTime(getEnd(), getLast(), timePoint));
+    }
+
+private:
+    char* getEnd() noexcept { return text_.data() + size_; }
+
+    // the last character is kept for the terminator
+    char* getLast() noexcept { return text_.data() + Capacity - 1; }
+
+    TextBuffer& setEnd(char* end) noexcept
+    {
+        *end = '\0';
+        size_ = size_t(end - text_.data());
+        return *this;
+    }
+
+private:
+    std::array<char, Capacity>                  text_;
+    size_t                                      size_;
+};
+
+} // namespace cmn
+
+#endif // !FORMAT_HPP
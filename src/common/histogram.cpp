@@ -0,0 +1,112 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"histogram.hpp"
+#include<algorithm>
+#include<assert.h>
+#include<cmath>
+#include<limits>
+
+namespace cmn {
+
+using namespace std;
+
+namespace {
+
+// index of the most significant bit, the value is not 0
+unsigned int getMostSignificantBit(unsigned long long int value) noexcept
+{
+    unsigned int bit{ 0 };
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+}
+
+} // namespace
+
+Histogram::Histogram()
+    :
+    buckets_    (numberOfBuckets_, 0),
+    count_      { 0 },
+    min_        { numeric_limits<unsigned long long int>::max() },
+    max_        { 0 },
+    sum_        { 0.0 }
+{}
+
+void Histogram::add(unsigned long long int value) noexcept
+{
+    ++buckets_[getIndex(value)];
+    ++count_;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    sum_ += double(value);
+}
+
+void Histogram::merge(const Histogram& other) noexcept
+{
+    for (size_t i = 0; i < numberOfBuckets_; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+}
+
+void Histogram::reset() noexcept
+{
+    fill(buckets_.begin(), buckets_.end(), 0);
+    count_ = 0;
+    min_ = numeric_limits<unsigned long long int>::max();
+    max_ = 0;
+    sum_ = 0.0;
+}
+
+unsigned long long int Histogram::getPercentile(double percentile) const noexcept
+{
+    if (count_ == 0) {
+        return 0;
+    }
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    const unsigned long long int rank{
+        std::max(1ull, static_cast<unsigned long long int>(ceil(percentile / 100.0 * count_)))
+    };
+    unsigned long long int counted{ 0 };
+    for (size_t i = 0; i < numberOfBuckets_; ++i) {
+        counted += buckets_[i];
+        if (counted >= rank) {
+            return std::clamp(getUpperBound(i), min_, max_);
+        }
+    }
+    return max_;
+}
+
+size_t Histogram::getIndex(unsigned long long int value) noexcept
+{
+    constexpr unsigned long long int numberOfExact{ 1ull << subBucketBits_ };
+    if (value < numberOfExact) {
+        return size_t(value);
+    }
+    // the value is shifted to keep 'subBucketBits_' significant bits
+    const unsigned int shift{ getMostSignificantBit(value) - subBucketBits_ + 1 };
+    const size_t index{ (size_t(shift) << (subBucketBits_ - 1)) + size_t(value >> shift) };
+    assert(index < numberOfBuckets_);
+    return index;
+}
+
+unsigned long long int Histogram::getUpperBound(size_t index) noexcept
+{
+    constexpr size_t numberOfExact{ size_t(1) << subBucketBits_ };
+    if (index < numberOfExact) {
+        return index;
+    }
+    const size_t half{ size_t(1) << (subBucketBits_ - 1) };
+    const unsigned int shift{ static_cast<unsigned int>(index / half - 1) };
+    const unsigned long long int top{ index - (size_t(shift) << (subBucketBits_ - 1)) };
+    return ((top + 1) << shift) - 1;
+}
+
+} // namespace cmn
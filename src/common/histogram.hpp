@@ -0,0 +1,61 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include<cstddef>
+#include<vector>
+
+namespace cmn {
+
+// Histogram of non-negative values with log-linear buckets in the manner of HdrHistogram:
+// the values below 2^(subBucketBits_) are counted exactly, every larger power of two
+// is split into 2^(subBucketBits_ - 1) buckets, so the relative error is below 1%.
+// The memory is allocated once by the constructor and does not depend on the number of values.
+class Histogram {
+public:
+    static constexpr unsigned int subBucketBits_{ 8 };
+    static constexpr size_t numberOfBuckets_{ (64 - subBucketBits_ + 2) << (subBucketBits_ - 1) };
+
+public:
+    Histogram();
+
+public:
+    void add(unsigned long long int value) noexcept;
+
+    // adds the values of the other histogram
+    void merge(const Histogram& other) noexcept;
+
+    void reset() noexcept;
+
+    unsigned long long int getCount() const noexcept { return count_; }
+
+    unsigned long long int getMin() const noexcept { return count_ == 0 ? 0 : min_; }
+
+    unsigned long long int getMax() const noexcept { return max_; }
+
+    double getMean() const noexcept { return count_ == 0 ? 0.0 : sum_ / count_; }
+
+    // the value not exceeded by 'percentile' percents of the values, 0 if there are no values;
+    // it is the upper bound of the bucket, so it is never less than the exact percentile
+    unsigned long long int getPercentile(double percentile) const noexcept;
+
+private:
+    static size_t getIndex(unsigned long long int value) noexcept;
+
+    static unsigned long long int getUpperBound(size_t index) noexcept;
+
+private:
+    std::vector<unsigned long long int>         buckets_;       // counts of the values
+    unsigned long long int                      count_;
+    unsigned long long int                      min_;
+    unsigned long long int                      max_;
+    double                                      sum_;
+};
+
+} // namespace cmn
+
+#endif // !HISTOGRAM_HPP
@@ -0,0 +1,110 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef QUEUE_HPP
+#define QUEUE_HPP
+
+#include<assert.h>
+#include<atomic>
+#include<memory>
+#include<utility>
+
+namespace cmn {
+
+// Bounded lock-free queue for many producers and a single consumer,
+// each cell has a sequence number telling whose turn it is to use the cell
+template <class T>
+class MPSCQueue {
+public:
+    explicit MPSCQueue(size_t capacity);
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    virtual ~MPSCQueue() noexcept {}
+
+public:
+    // can be called from any thread, returns false if the queue is full
+    bool push(T value);
+
+    // must be called only from the consumer thread, returns false if the queue is empty
+    bool pop(T& value);
+
+    size_t getCapacity() const noexcept { return mask_ + 1; }
+
+private:
+    static constexpr size_t cacheLineSize_{ 64 };
+
+    struct Cell {
+        std::atomic<size_t>                     sequence_;
+        T                                       value_;
+    };
+
+private:
+    std::unique_ptr<Cell[]>                     cells_;
+    const size_t                                mask_;
+    alignas(cacheLineSize_) std::atomic<size_t> tail_;          // position of the next push
+    alignas(cacheLineSize_) size_t              head_;          // position of the next pop
+};
+
+///************************************************************************************************
+
+template <class T>
+MPSCQueue<T>::MPSCQueue(size_t capacity)
+    :
+    cells_          { new Cell[capacity] },
+    mask_           { capacity - 1 },
+    tail_           { 0 },
+    head_           { 0 }
+{
+    assert(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+    for (size_t i = 0; i < capacity; ++i) {
+        cells_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <class T>
+bool MPSCQueue<T>::push(T value)
+{
+    size_t pos{ tail_.load(std::memory_order_relaxed) };
+    Cell* cell{ nullptr };
+    while (true) {
+        cell = &cells_[pos & mask_];
+        const size_t sequence{ cell->sequence_.load(std::memory_order_acquire) };
+        const auto diff{ static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos) };
+        if (diff == 0) {
+            if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // the cell has not been popped yet since the previous lap
+            return false;
+        }
+        else {
+            pos = tail_.load(std::memory_order_relaxed);
+        }
+    }
+    cell->value_ = std::move(value);
+    cell->sequence_.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template <class T>
+bool MPSCQueue<T>::pop(T& value)
+{
+    Cell& cell{ cells_[head_ & mask_] };
+    if (cell.sequence_.load(std::memory_order_acquire) != head_ + 1) {
+        return false;
+    }
+    value = std::move(cell.value_);
+    cell.sequence_.store(head_ + mask_ + 1, std::memory_order_release);
+    ++head_;
+    return true;
+}
+
+} // namespace cmn
+
+#endif // !QUEUE_HPP
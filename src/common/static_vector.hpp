@@ -0,0 +1,77 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef STATIC_VECTOR_HPP
+#define STATIC_VECTOR_HPP
+
+#include<array>
+#include<assert.h>
+#include<initializer_list>
+
+namespace cmn {
+
+// Vector with the fixed capacity, the elements are stored inline
+template <class T, size_t Capacity>
+class StaticVector {
+public:
+    using value_type        = T;
+    using iterator          = T*;
+    using const_iterator    = const T*;
+
+public:
+    StaticVector() noexcept : data_{}, size_{ 0 } {}
+
+    StaticVector(std::initializer_list<T> values) : data_{}, size_{ 0 }
+    {
+        for (const T& value : values) {
+            push_back(value);
+        }
+    }
+
+public:
+    static constexpr size_t capacity() noexcept { return Capacity; }
+
+    size_t size() const noexcept { return size_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    bool full() const noexcept { return size_ == Capacity; }
+
+    void clear() noexcept { size_ = 0; }
+
+    void push_back(const T& value)
+    {
+        assert(size_ < Capacity);
+        data_[size_++] = value;
+    }
+
+    T& operator[](size_t index) { assert(index < size_); return data_[index]; }
+
+    const T& operator[](size_t index) const { assert(index < size_); return data_[index]; }
+
+    T& back() { assert(size_ > 0); return data_[size_ - 1]; }
+
+    const T& back() const { assert(size_ > 0); return data_[size_ - 1]; }
+
+    iterator begin() noexcept { return data_.data(); }
+
+    iterator end() noexcept { return data_.data() + size_; }
+
+    const_iterator begin() const noexcept { return data_.data(); }
+
+    const_iterator end() const noexcept { return data_.data() + size_; }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    const_iterator cend() const noexcept { return end(); }
+
+private:
+    std::array<T, Capacity>                     data_;
+    size_t                                      size_;
+};
+
+} // namespace cmn
+
+#endif // !STATIC_VECTOR_HPP
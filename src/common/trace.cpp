@@ -0,0 +1,137 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"trace.hpp"
+#include<atomic>
+#include<fstream>
+#include<iomanip>
+#include<set>
+#include<utility>
+
+namespace cmn {
+
+using namespace std;
+
+namespace {
+
+// the trace has a process for each clock
+constexpr int simulationPid{ 1 };
+constexpr int wallClockPid{ 2 };
+
+atomic<int> nextThreadID{ 1 };
+
+void writeString(ostream& os, string_view s)
+{
+    os << '"';
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            os << '\\';
+        }
+        os << c;
+    }
+    os << '"';
+}
+
+// the trace-event timestamps are microseconds
+void writeMicroseconds(ostream& os, long long int nanoseconds)
+{
+    os << nanoseconds / 1000 << '.' << setw(3) << setfill('0') << nanoseconds % 1000 << setfill(' ');
+}
+
+void writeProcessName(ostream& os, int pid, const char* name)
+{
+    os << u8"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+        << u8",\"tid\":0,\"args\":{\"name\":\"" << name << u8"\"}}";
+}
+
+} // namespace
+
+Tracer::Tracer() noexcept
+    :
+    transitions_    {},
+    spans_          {},
+    numTransitions_ { 0 },
+    numSpans_       { 0 },
+    startTime_      {},
+    tick_           { 0 },
+    isEnabled_      { false }
+{}
+
+void Tracer::start(size_t numTransitions, size_t numSpans)
+{
+    assert(numTransitions > 0);
+    auto getCapacity{ [](size_t n) {
+        size_t capacity{ 1 };
+        while (capacity < n) {
+            capacity <<= 1;
+        }
+        return capacity;
+    } };
+    transitions_.assign(getCapacity(numTransitions), Transition{});
+    spans_.assign(numSpans == 0 ? 0 : getCapacity(numSpans), Span{});
+    numTransitions_ = 0;
+    numSpans_ = 0;
+    startTime_ = chrono::steady_clock::now();
+    isEnabled_ = true;
+}
+
+void Tracer::write(ostream& os) const
+{
+    static thread_local const int threadID{ nextThreadID.fetch_add(1) };
+    os << u8"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    writeProcessName(os, simulationPid, u8"Simulation clock");
+    os << u8",\n";
+    writeProcessName(os, wallClockPid, u8"Wall clock");
+
+    // the oldest records are overwritten, so a state is ended only if its beginning is kept
+    set<pair<const TraceCategory*, unsigned long long int>> begun;
+    const size_t firstTransition{
+        numTransitions_ > transitions_.size() ? size_t(numTransitions_ - transitions_.size()) : 0
+    };
+    for (unsigned long long int i = firstTransition; i < numTransitions_; ++i) {
+        const Transition& t{ transitions_[i & (transitions_.size() - 1)] };
+        const auto key{ make_pair(t.category_, t.id_) };
+        auto writeEvent{ [&](char phase, int state) {
+            os << u8",\n{\"name\":";
+            writeString(os, t.category_->getStateName_(state));
+            os << u8",\"cat\":\"" << t.category_->name_ << u8"\",\"ph\":\"" << phase
+                << u8"\",\"id\":" << t.id_ << u8",\"pid\":" << simulationPid
+                << u8",\"tid\":" << threadID << u8",\"ts\":";
+            writeMicroseconds(os, toDuration(t.tick_).count());
+            os << u8",\"args\":{\"id\":" << t.id_ << u8"}}";
+        } };
+        if (t.from_ >= 0 && begun.erase(key) > 0) {
+            writeEvent('e', t.from_);
+        }
+        if (t.to_ >= 0) {
+            writeEvent('b', t.to_);
+            begun.insert(key);
+        }
+    }
+
+    const size_t firstSpan{ numSpans_ > spans_.size() ? size_t(numSpans_ - spans_.size()) : 0 };
+    for (unsigned long long int i = firstSpan; i < numSpans_; ++i) {
+        const Span& s{ spans_[i & (spans_.size() - 1)] };
+        os << u8",\n{\"name\":\"" << s.name_ << u8"\",\"cat\":\"span\",\"ph\":\"X\",\"pid\":"
+            << wallClockPid << u8",\"tid\":" << threadID << u8",\"ts\":";
+        writeMicroseconds(os, s.begin_);
+        os << u8",\"dur\":";
+        writeMicroseconds(os, s.duration_);
+        os << '}';
+    }
+    os << u8"\n]}\n";
+}
+
+bool Tracer::write(const string& fileName) const
+{
+    ofstream file{ fileName };
+    if (file.is_open() == false) {
+        return false;
+    }
+    this->write(file);
+    return file.good();
+}
+
+} // namespace cmn
@@ -0,0 +1,161 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include"common.hpp"
+#include<chrono>
+#include<ostream>
+#include<string>
+#include<string_view>
+#include<vector>
+
+namespace cmn {
+
+// kind of the traced objects, the records keep only the indexes of the states
+struct TraceCategory {
+    const char*                                 name_;
+    std::string_view                            (*getStateName_)(int state);
+};
+
+// Recorder of the state transitions on the simulation clock and of the spans of work
+// on the wall clock. The records are kept in two ring buffers, so the newest ones survive
+// in long runs; nothing is allocated while recording. Every thread has its own tracer.
+// A transition costs a store, a span reads the clock twice, so long runs may keep the spans off.
+class Tracer {
+public:
+    static constexpr size_t defTransitions_{ 1 << 20 };
+    static constexpr size_t defSpans_{ 1 << 16 };
+
+public:
+    static Tracer& instance() noexcept
+    {
+        static thread_local Tracer tracer;
+        return tracer;
+    }
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    virtual ~Tracer() noexcept {}
+
+public:
+    // drops the previous records, the capacities are rounded up to powers of two, no spans if 'numSpans' is 0
+    void start(size_t numTransitions = defTransitions_, size_t numSpans = defSpans_);
+
+    // the records are kept for writing
+    void stop() noexcept { isEnabled_ = false; }
+
+    bool isEnabled() const noexcept { return isEnabled_; }
+
+    bool isSpanEnabled() const noexcept { return isEnabled_ && spans_.empty() == false; }
+
+    // time of the simulation for the following transitions
+    void setTick(tick_t tick) noexcept { tick_ = tick; }
+
+    // the state 'from' of the object ends and the state 'to' begins,
+    // a negative state means that the object has no state
+    void addTransition(const TraceCategory& category, unsigned long long int id, int from, int to) noexcept;
+
+    // 'name' must be a string literal
+    void addSpan(const char* name, std::chrono::steady_clock::time_point begin,
+        std::chrono::steady_clock::time_point end) noexcept;
+
+    unsigned long long int getNumberOfTransitions() const noexcept { return numTransitions_; }
+
+    unsigned long long int getNumberOfSpans() const noexcept { return numSpans_; }
+
+    // Chrome trace-event JSON, it can be opened in Perfetto or chrome://tracing
+    void write(std::ostream& os) const;
+
+    // returns false if the file can not be written
+    bool write(const std::string& fileName) const;
+
+private:
+    Tracer() noexcept;
+
+private:
+    struct Transition {
+        tick_t                                  tick_;
+        unsigned long long int                  id_;
+        const TraceCategory*                    category_;
+        signed char                             from_;
+        signed char                             to_;
+    };
+
+    struct Span {
+        long long int                           begin_;         // nanoseconds since the start of the tracer
+        long long int                           duration_;      // nanoseconds
+        const char*                             name_;
+    };
+
+private:
+    std::vector<Transition>                     transitions_;   // ring buffer
+    std::vector<Span>                           spans_;         // ring buffer
+    unsigned long long int                      numTransitions_; // recorded since the start
+    unsigned long long int                      numSpans_;      // recorded since the start
+    std::chrono::steady_clock::time_point       startTime_;
+    tick_t                                      tick_;
+    bool                                        isEnabled_;
+};
+
+// span of work from the construction to the destruction
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name) noexcept
+        :
+        tracer_ { Tracer::instance() },
+        name_   { name },
+        begin_  { tracer_.isSpanEnabled() ? std::chrono::steady_clock::now()
+                                      : std::chrono::steady_clock::time_point{} }
+    {}
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    ~TraceSpan() noexcept
+    {
+        if (tracer_.isSpanEnabled() && begin_ != std::chrono::steady_clock::time_point{}) {
+            tracer_.addSpan(name_, begin_, std::chrono::steady_clock::now());
+        }
+    }
+
+private:
+    Tracer&                                     tracer_;
+    const char*                                 name_;
+    const std::chrono::steady_clock::time_point begin_;
+};
+
+inline void Tracer::addTransition(const TraceCategory& category, unsigned long long int id,
+                                  int from, int to) noexcept
+{
+    if (isEnabled_ == false) {
+        return;
+    }
+    transitions_[numTransitions_ & (transitions_.size() - 1)] = Transition{
+        tick_, id, &category, static_cast<signed char>(from), static_cast<signed char>(to)
+    };
+    ++numTransitions_;
+}
+
+inline void Tracer::addSpan(const char* name, std::chrono::steady_clock::time_point begin,
+                            std::chrono::steady_clock::time_point end) noexcept
+{
+    using namespace std::chrono;
+    if (this->isSpanEnabled() == false) {
+        return;
+    }
+    spans_[numSpans_ & (spans_.size() - 1)] = Span{
+        duration_cast<nanoseconds>(begin - startTime_).count(),
+        duration_cast<nanoseconds>(end - begin).count(),
+        name
+    };
+    ++numSpans_;
+}
+
+} // namespace cmn
+
+#endif // !TRACE_HPP
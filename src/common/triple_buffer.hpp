@@ -0,0 +1,81 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include<array>
+#include<atomic>
+
+namespace cmn {
+
+// Latest value passed from a single writer to a single reader without locks or waiting:
+// the writer fills the back buffer, the reader keeps the front one,
+// and the middle one is exchanged with an atomic index
+template <class T>
+class TripleBuffer {
+public:
+    TripleBuffer();
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    virtual ~TripleBuffer() noexcept {}
+
+public:
+    // must be called only from the writer thread
+    T& getBack() noexcept { return buffers_[back_]; }
+
+    // must be called only from the writer thread, the back buffer becomes the latest value
+    void publish() noexcept;
+
+    // must be called only from the reader thread, returns false if nothing has been published
+    // since the previous call, the front buffer keeps the latest value anyway
+    bool update() noexcept;
+
+    // must be called only from the reader thread
+    const T& getFront() const noexcept { return buffers_[front_]; }
+
+private:
+    static constexpr unsigned int indexMask_{ 3 };
+    static constexpr unsigned int newFlag_{ 4 };    // the middle buffer has not been read
+
+private:
+    std::array<T, 3>                            buffers_;
+    std::atomic<unsigned int>                   middle_;        // index of the middle buffer and the flag
+    unsigned int                                back_;
+    unsigned int                                front_;
+};
+
+///************************************************************************************************
+
+template <class T>
+TripleBuffer<T>::TripleBuffer()
+    :
+    buffers_        {},
+    middle_         { 1 },
+    back_           { 0 },
+    front_          { 2 }
+{}
+
+template <class T>
+void TripleBuffer<T>::publish() noexcept
+{
+    back_ = middle_.exchange(back_ | newFlag_, std::memory_order_acq_rel) & indexMask_;
+}
+
+template <class T>
+bool TripleBuffer<T>::update() noexcept
+{
+    if ((middle_.load(std::memory_order_relaxed) & newFlag_) == 0) {
+        return false;
+    }
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & indexMask_;
+    return true;
+}
+
+} // namespace cmn
+
+#endif // !TRIPLE_BUFFER_HPP
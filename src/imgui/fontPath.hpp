@@ -7,6 +7,6 @@
 #ifndef FONT_PATH_HPP
 #define FONT_PATH_HPP
 
-#define FONT_UBUNTU_R_FILE__NATIVE_REL_PATH u8R"(data\fonts\Ubuntu-R.ttf)"
+#define FONT_UBUNTU_R_FILE__NATIVE_REL_PATH u8R"(data/fonts/Ubuntu-R.ttf)"
 
 #endif // !FONT_PATH_HPP
@@ -7,8 +7,11 @@
 #include"common.hpp"
 #include"courier.hpp"
 #include"delivery.hpp"
+#include"eventlog.hpp"
+#include"generator.hpp"
 #include"graphicUI.hpp"
 #include"map.hpp"
+#include"metrics.hpp"
 #include"msystem.hpp"
 #include"options.hpp"
 #include"scheduler.hpp"
@@ -19,44 +22,57 @@
 #include<iostream>
 #include<memory>
 #include<numeric>
+#include<string>
 #include<thread>
 #include<vector>
 
-bool createOrder(std::chrono::nanoseconds elapsedTime)
+namespace {
+
+// files written during the session, nothing is written by default
+struct SessionFiles {
+    bool                                        isRecorded_;    // events for pizza-ds-replay
+    std::chrono::milliseconds                   metricsPeriod_; // 0 - no metrics
+};
+
+// the arguments are "record=0|1" and "metrics=<period, ms>" as of pizza-ds-bench
+bool parseArguments(int argc, char* argv[], SessionFiles& files)
 {
-    using namespace std::chrono;
-    constexpr unsigned int chance{ 5 };
-    constexpr unsigned int step{ 2 };
-    constexpr unsigned int stepBig{ step * 5 };
-    constexpr unsigned int from{ 1 };
-    static unsigned int to{ 50 };
-    constexpr unsigned int toMin{ 10 };
-    constexpr unsigned int toMax{ 100 };
-    static nanoseconds time{ 0 };
-    time += elapsedTime;
-    if (time >= seconds{ 60 }) {
-        time = nanoseconds{ 0 };
-        const auto random{ cmn::getRandomNumber(from, to) };
-        if (random >= from && random <= chance) {
-            if (to <= toMax - stepBig) {
-                to += stepBig;
-            }
-            return true;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument{ argv[i] };
+        const size_t equal{ argument.find('=') };
+        if (equal == std::string::npos || equal + 1 == argument.size() || argument.size() - equal > 10
+            || argument.find_first_not_of(u8"0123456789", equal + 1) != std::string::npos)
+        {
+            return false;
+        }
+        const unsigned long long int value{ std::stoull(argument.substr(equal + 1)) };
+        const std::string name{ argument.substr(0, equal) };
+        if (name == u8"record" && value <= 1) {
+            files.isRecorded_ = value == 1;
+        }
+        else if (name == u8"metrics" && value <= 60 * 60 * 1000) {
+            files.metricsPeriod_ = std::chrono::milliseconds{ value };
         }
         else {
-            if (to >= toMin + step) {
-                to -= step;
-            }
+            return false;
         }
     }
-    return false;
+    return true;
 }
 
+} // namespace
+
 int main(int argc, char* argv[])
 {
     using namespace std;
 
     try {
+        SessionFiles files{ false, chrono::milliseconds{ 0 } };
+        if (parseArguments(argc, argv, files) == false) {
+            cerr << u8"usage: pizza-ds [record=0|1] [metrics=<period, milliseconds, 0 - none>]" << endl;
+            return EXIT_FAILURE;
+        }
+
         WNDCLASSEXW wc;
         HWND hWnd;
         if (!initializeGUI(wc, hWnd)) return -1;
@@ -67,11 +83,20 @@ int main(int argc, char* argv[])
         ds::Scheduler scheduler{ office };
         ds::Kitchen kitchen{};
         ds::Delivery delivery{};
-        ds::ManagmentSystem ms{ map, scheduler, kitchen, delivery };
+        ds::ManagmentSystem ms{ map, scheduler, kitchen, delivery, ds::OptionsSimulation{ ds::Options::instance() } };
         scheduler.setManagmentSystem(&ms);
         kitchen.setManagmentSystem(&ms);
         delivery.setManagmentSystem(&ms);
 
+        // the recorded session can be replayed headless by pizza-ds-replay
+        unique_ptr<ds::EventLog> eventLog{};
+        if (files.isRecorded_) {
+            eventLog = make_unique<ds::EventLog>(u8"pizza-ds.events");
+            if (eventLog->isOpen()) {
+                ms.setEventLog(eventLog.get());
+            }
+        }
+
         ms.activateKitchener(ds::WorkerID{ 11 }, ds::KitchenerType::DOUGH);
         ms.activateKitchener(ds::WorkerID{ 12 }, ds::KitchenerType::DOUGH);
         ms.activateKitchener(ds::WorkerID{ 13 }, ds::KitchenerType::FILLING);
@@ -86,6 +111,11 @@ int main(int argc, char* argv[])
         ms.activateCourier(ds::WorkerID{ 2 });
         ms.createOrder();
         ms.createOrder();
+        ds::OrderGenerator generator{ ms };
+        unique_ptr<ds::MetricsExporter> exporter{};
+        if (files.metricsPeriod_.count() > 0) {
+            exporter = make_unique<ds::MetricsExporter>(ms, u8"pizza-ds.prom", files.metricsPeriod_);
+        }
 
 
         const unsigned int sleepForTimeCapacity{ 20 };
@@ -100,11 +130,17 @@ int main(int argc, char* argv[])
             auto elapsedTime{ frameStart - prevFS };
             prevFS = frameStart;
 
-            if (createOrder(elapsedTime * ds::Options::instance().timeSpeed_)) {
-                ms.createOrder();
-            }
+            generator.update(elapsedTime * ds::Options::instance().timeSpeed_);
 
+            // the options edited in the menu since the last frame are taken by the system at the start of its update
+            if (ds::Options::instance().isChanged_) {
+                ds::Options::instance().isChanged_ = false;
+                ms.setOptions(ds::OptionsSimulation{ ds::Options::instance() });
+            }
             ms.update(elapsedTime * ds::Options::instance().timeSpeed_);
+            if (exporter != nullptr) {
+                exporter->update();
+            }
             renderGUI(&showGuiMenuMain, ms);
 
             npf = chrono::nanoseconds{ nano::den / ds::Options::instance().fps_ };
@@ -122,6 +158,10 @@ int main(int argc, char* argv[])
             sleepForTime.push_back(t2 - t1 - sleepTime);
         }
 
+        ms.setEventLog(nullptr);
+        if (eventLog != nullptr && eventLog->isOpen()) {
+            eventLog->finish(ms);
+        }
         shutdownGUI(wc, hWnd);
     }
     catch (const std::exception& e) {
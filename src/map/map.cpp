@@ -5,11 +5,39 @@
 // (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
 
 #include"map.hpp"
+#include"trace.hpp"
 
 namespace ds {
 
 using namespace std;
 
+namespace {
+
+// counts the search and adds its duration
+class SearchTimer {
+public:
+    SearchTimer(atomic<unsigned long long int>& searches, atomic<long long int>& searchTime) noexcept
+        :
+        searchTime_ { searchTime },
+        begin_      { chrono::steady_clock::now() }
+    {
+        searches.fetch_add(1, memory_order_relaxed);
+    }
+
+    ~SearchTimer() noexcept
+    {
+        const auto duration{ chrono::steady_clock::now() - begin_ };
+        searchTime_.fetch_add(chrono::duration_cast<chrono::nanoseconds>(duration).count(),
+            memory_order_relaxed);
+    }
+
+private:
+    atomic<long long int>&                      searchTime_;
+    const chrono::steady_clock::time_point      begin_;
+};
+
+} // namespace
+
 bool operator==(const GraphRC& rc1, const GraphRC& rc2)
 {
     return rc1.distance_ == rc2.distance_
@@ -54,7 +82,7 @@ int calcDistance(const Map& map, int edgeSrcVertex, int edgeTgtVertex)
 }
 
 Map::Map()
-    : g_{}
+    : g_{}, searches_{ 0 }, searchTime_{ 0 }, timeouts_{ 0 }, version_{ 0 }
 {
     addVertex(0, 0);
     addVertex(200, 0);
@@ -97,62 +125,158 @@ Map::Map()
     addEdge(7, 1, distance);
 }
 
-std::vector<Graph::edge_descriptor> Map::getPath(size_t srcVertex, size_t tgtVertex)
+Map::Map(size_t columns, size_t rows, int spacing)
+    : g_{}, searches_{ 0 }, searchTime_{ 0 }, timeouts_{ 0 }, version_{ 0 }
 {
+    assert(columns > 0 && rows > 0 && spacing > 0);
+    for (size_t row = 0; row < rows; ++row) {
+        for (size_t column = 0; column < columns; ++column) {
+            addVertex(int(column) * spacing, int(row) * spacing);
+        }
+    }
+
+    const int distance{ spacing * Options::instance().optMap_.scale_ };
+    for (size_t row = 0; row < rows; ++row) {
+        for (size_t column = 0; column < columns; ++column) {
+            const size_t vertex{ row * columns + column };
+            if (column + 1 < columns) {
+                addEdge(vertex, vertex + 1, distance);
+                addEdge(vertex + 1, vertex, distance);
+            }
+            if (row + 1 < rows) {
+                addEdge(vertex, vertex + columns, distance);
+                addEdge(vertex + columns, vertex, distance);
+            }
+        }
+    }
+}
+
+std::vector<Graph::edge_descriptor> Map::getPath(size_t srcVertex, size_t tgtVertex,
+                                                 const OptionsSimulation& options) const
+{
+    vector<Graph::edge_descriptor> path{};
+    if (findPath(srcVertex, tgtVertex, path, options) == false) throw;
+    return path;
+}
+
+bool Map::findPath(size_t srcVertex, size_t tgtVertex,
+                   std::vector<Graph::edge_descriptor>& path,
+                   const OptionsSimulation& options) const
+{
+    const cmn::TraceSpan span{ u8"Map::findPath" };
+    const SearchTimer timer{ searches_, searchTime_ };
     vector<vector<Graph::edge_descriptor>> optSolutions;
     vector<GraphRC> paretoOptRCS;
     r_c_shortest_paths(g_, get(&GraphVertexPropertyMap::num_, g_),
         get(&GraphEdgePropertyMap::num_, g_), srcVertex, tgtVertex,
-        optSolutions, paretoOptRCS, GraphRC{ 0, 0 }, GraphREF{}, GraphDF{},
+        optSolutions, paretoOptRCS, GraphRC{ 0, 0 }, GraphREF{ options }, GraphDF{},
         std::allocator<boost::r_c_shortest_paths_label<Graph, GraphRC>>(),
         boost::default_r_c_shortest_paths_visitor());
 
-    if (optSolutions.size() < 1) throw;
-    vector<Graph::edge_descriptor> path{};
+    if (optSolutions.size() < 1) return false;
+    path.clear();
     path.reserve(optSolutions[0].size());
     for (int i = optSolutions[0].size() - 1; i >= 0; --i) {
         path.push_back(optSolutions[0][i]);
     }
-    return path;
+    return true;
 }
 
 MapPath Map::getPath(const Graph::vertex_descriptor srcVertex,
-                     const vector<Graph::vertex_descriptor>& tgtVertices,
-                     const vector<chrono::seconds>& remainingTime)
+                     const vector<MapTarget>& targets,
+                     long long int currentTime,
+                     const OptionsSimulation& options) const
 {
-    assert(tgtVertices.size() == remainingTime.size());
-    assert(tgtVertices.empty() == false);
-    MapPath mp;
+    assert(targets.empty() == false);
+    const cmn::TraceSpan span{ u8"Map::getPath" };
+    const SearchTimer timer{ searches_, searchTime_ };
+    GraphSearch2 search{
+        size_t(options.optDelivery_.maxRouteLabels_), chrono::milliseconds{ options.optDelivery_.maxRouteTime_ }
+    };
     vector<vector<Graph::edge_descriptor>> optSolutions;
     vector<GraphRC2> paretoOptRCs;
     r_c_shortest_paths(g_, get(&GraphVertexPropertyMap::num_, g_),
         get(&GraphEdgePropertyMap::num_, g_),
         srcVertex, srcVertex,
         optSolutions, paretoOptRCs,
-        GraphRC2{ tgtVertices, remainingTime, 0, 0 }, GraphREF2{}, GraphDF2{},
+        GraphRC2{ targets, currentTime, 0, 0 }, GraphREF2{ options }, GraphDF2{},
         std::allocator<boost::r_c_shortest_paths_label<Graph, GraphRC2>>(),
-        boost::default_r_c_shortest_paths_visitor());
+        GraphVisitor2{ search });
 
-    if (optSolutions.empty() == true || optSolutions[0].empty() == true) {
-        mp.path_ = getPath(srcVertex, tgtVertices[0]);
+    if (search.complete_ == false && search.labels_ < search.maxLabels_) {
+        timeouts_.fetch_add(1, memory_order_relaxed);
+    }
+    MapPath mp{};
+    if (search.complete_ == false && search.bestVisited_.empty() == false) {
+        // the budget is exhausted, the best route found so far is used
+        mp = makePath(search.bestPath_, std::move(search.bestVisited_), targets);
+    }
+    else if (optSolutions.empty() == true || optSolutions[0].empty() == true) {
+        mp.path_ = getPath(srcVertex, targets[0].vertex_, options);
         mp.visited_.push_back(0);
-        return mp;
     }
-    const Graph::vertex_descriptor lastVisited{
-        tgtVertices[paretoOptRCs[0].visited_[paretoOptRCs[0].visited_.size() - 1]]
-    };
-    int i{ 0 };
-    for (; i < optSolutions[0].size(); ++i) {
-        if (lastVisited == optSolutions[0][i].m_source) {
-            mp.path_.reserve(optSolutions[0].size() - (i + 1));
+    else {
+        mp = makePath(optSolutions[0], std::move(paretoOptRCs[0].visited_), targets);
+    }
+    mp.labels_ = search.labels_;
+    mp.labelBytes_ = search.labelBytes_;
+    mp.complete_ = search.complete_;
+    return mp;
+}
+
+MapPath Map::makePath(const vector<Graph::edge_descriptor>& reversedPath,
+                      vector<size_t>&& visited,
+                      const vector<MapTarget>& targets)
+{
+    // the path ends at the last visited target
+    assert(visited.empty() == false);
+    MapPath mp{};
+    const Graph::vertex_descriptor lastVisited{ targets[visited.back()].vertex_ };
+    size_t i{ 0 };
+    for (; i < reversedPath.size(); ++i) {
+        if (lastVisited == reversedPath[i].m_target) {
             break;
         }
     }
-    for (int j = optSolutions[0].size() - 1; j > i; --j) {
-        mp.path_.push_back(optSolutions[0][j]);
+    mp.path_.reserve(reversedPath.size() - i);
+    for (size_t j = reversedPath.size(); j-- > i;) {
+        mp.path_.push_back(reversedPath[j]);
     }
-    mp.visited_ = std::move(paretoOptRCs[0].visited_);
+    mp.visited_ = std::move(visited);
     return mp;
 }
 
+///************************************************************************************************
+
+MapPathCache::MapPathCache(const Map& map)
+    :
+    map_            { map },
+    paths_          {},
+    emptyPath_      {},
+    version_        { map.getVersion() },
+    deliveryTime_   { OptionsDelivery::defDeliveryTime_ }
+{}
+
+const vector<Graph::edge_descriptor>* MapPathCache::findPath(size_t srcVertex, size_t tgtVertex,
+                                                             const OptionsSimulation& options)
+{
+    if (srcVertex == tgtVertex) {
+        return &emptyPath_;
+    }
+    const int deliveryTime{ options.optDelivery_.deliveryTime_ };
+    if (version_ != map_.getVersion() || deliveryTime_ != deliveryTime) {
+        paths_.clear();
+        version_ = map_.getVersion();
+        deliveryTime_ = deliveryTime;
+    }
+    const unsigned long long int key{ (static_cast<unsigned long long int>(srcVertex) << 32) | tgtVertex };
+    auto iter{ paths_.find(key) };
+    if (iter == paths_.end()) {
+        Entry entry{ false, {} };
+        entry.isFound_ = map_.findPath(srcVertex, tgtVertex, entry.path_, options);
+        iter = paths_.emplace(key, std::move(entry)).first;
+    }
+    return iter->second.isFound_ ? &iter->second.path_ : nullptr;
+}
+
 } // namespace ds
@@ -9,10 +9,14 @@
 
 #include"options.hpp"
 #include<algorithm>
+#include<atomic>
 #include<boost/graph/adjacency_list.hpp>
 #include<boost/graph/graph_traits.hpp>
 #include<boost/graph/r_c_shortest_paths.hpp>
 #include<chrono>
+#include<unordered_map>
+#include<utility>
+#include<vector>
 
 namespace ds {
 
@@ -51,30 +55,41 @@ bool operator==(const GraphRC& rc1, const GraphRC& rc2);
 
 bool operator<(const GraphRC& rc1, const GraphRC& rc2);
 
+// target of the path with the deadline to reach it
+struct MapTarget {
+    Graph::vertex_descriptor                        vertex_;
+    long long int                                   deadline_;      // seconds since the start of the simulation
+};
+
 struct GraphRC2 {
     GraphRC2(
-        const std::vector<Graph::vertex_descriptor>& tgtVertices,
-        const std::vector<std::chrono::seconds>& remainingTime,
+        const std::vector<MapTarget>& targets,
+        long long int currentTime,
         int distance,
         int time)
         :
-        tgtVertices_    { tgtVertices },
-        remainingTime_  { remainingTime },
+        targets_        { targets },
+        currentTime_    { currentTime },
         visited_        {},
         distance_       { distance },
         time_           { time },
         tgt0InPath_     { false }
     {
-        assert(tgtVertices_.size() == remainingTime_.size());
-        assert(tgtVertices_.size() > 0);
+        assert(targets_.size() > 0);
+    }
+
+    // remaining time to reach the target, it is calculated only when the target is reached
+    int getRemainingTime(size_t index) const
+    {
+        return int(targets_[index].deadline_ - currentTime_);
     }
 
-    const std::vector<Graph::vertex_descriptor>&    tgtVertices_;
-    const std::vector<std::chrono::seconds>&        remainingTime_; // remaining time to deliver
-    std::vector<size_t>                             visited_;       // indexes of visited vertices in 'tgtVertices_'
+    const std::vector<MapTarget>&                   targets_;
+    long long int                                   currentTime_;   // seconds since the start of the simulation
+    std::vector<size_t>                             visited_;       // indexes of visited vertices in 'targets_'
     int                                             distance_;      // meters
     int                                             time_;          // seconds
-    bool                                            tgt0InPath_;    // the 1st target vertex ('tgtVertices_[0]') is on the path
+    bool                                            tgt0InPath_;    // the 1st target vertex ('targets_[0]') is on the path
 };
 
 bool operator==(const GraphRC2& rc1, const GraphRC2& rc2);
@@ -84,39 +99,56 @@ bool operator<(const GraphRC2& rc1, const GraphRC2& rc2);
 // ResourceExtensionFunction model
 class GraphREF {
 public:
+    explicit GraphREF(const OptionsSimulation& options) noexcept
+        :
+        maxTime_        { options.optDelivery_.deliveryTime_ }
+    {}
+
     inline bool operator()(const Graph& g, GraphRC& newRC, const GraphRC& oldRC,
         boost::graph_traits<Graph>::edge_descriptor ed) const
     {
         newRC.distance_ = oldRC.distance_ + g[ed].distance_;
         newRC.time_     = oldRC.time_     + g[ed].time_;
-        return newRC.time_ <= Options::instance().optDelivery_.deliveryTime_;
+        return newRC.time_ <= maxTime_;
     }
+
+private:
+    int                                         maxTime_;       // seconds
 };
 
 class GraphREF2 {
 public:
+    explicit GraphREF2(const OptionsSimulation& options) noexcept
+        :
+        maxTime_        { options.optDelivery_.deliveryTime_ * 2 },
+        stopTime_       { options.optCourier_.deliveryTime_ + options.optCourier_.paymentTime_ }
+    {}
+
     inline bool operator()(const Graph& g, GraphRC2& newRC, const GraphRC2& oldRC,
         boost::graph_traits<Graph>::edge_descriptor ed) const
     {
         newRC.distance_ = oldRC.distance_ + g[ed].distance_;
         newRC.time_     = oldRC.time_     + g[ed].time_;
-        for (int i = 0; i < newRC.tgtVertices_.size(); ++i) {
-            if (newRC.tgtVertices_[i] == g[ed.m_target].num_ &&
+        for (size_t i = 0; i < newRC.targets_.size(); ++i) {
+            if (newRC.targets_[i].vertex_ == g[ed.m_target].num_ &&
                 find(newRC.visited_.cbegin(), newRC.visited_.cend(), i) == newRC.visited_.cend())
             {
                 if (i == 0) {
                     newRC.tgt0InPath_ = true;
                 }
-                if (i > 0 && newRC.time_ > newRC.remainingTime_[i].count()) {
+                if (i > 0 && newRC.time_ > newRC.getRemainingTime(i)) {
                     continue;
                 }
                 newRC.visited_.push_back(i);
-                newRC.time_ += Options::instance().optCourier_.deliveryTime_;
-                newRC.time_ += Options::instance().optCourier_.paymentTime_;
+                newRC.time_ += stopTime_;
             }
         }
-        return newRC.time_ <= Options::instance().optDelivery_.deliveryTime_ * 2;
+        return newRC.time_ <= maxTime_;
     }
+
+private:
+    int                                         maxTime_;       // seconds
+    int                                         stopTime_;      // delivery and payment at a target, seconds
 };
 
 // DominanceFunction model
@@ -137,16 +169,106 @@ public:
     }
 };
 
+// State of the multi-target search, shared by the copies of the visitor
+struct GraphSearch2 {
+    GraphSearch2(size_t maxLabels, std::chrono::nanoseconds maxTime)
+        :
+        maxLabels_      { maxLabels },
+        maxTime_        { maxTime },
+        start_          { std::chrono::steady_clock::now() },
+        labels_         { 0 },
+        labelBytes_     { 0 },
+        loops_          { 0 },
+        complete_       { true },
+        bestVisited_    {},
+        bestTime_       { 0 },
+        bestPath_       {}
+    {}
+
+    size_t                                          maxLabels_;
+    std::chrono::nanoseconds                        maxTime_;       // 0 - the time is not limited
+    std::chrono::steady_clock::time_point           start_;
+    size_t                                          labels_;        // generated labels
+    size_t                                          labelBytes_;    // approximate memory of the feasible labels
+    size_t                                          loops_;
+    bool                                            complete_;      // the search was not stopped by the budget
+    std::vector<size_t>                             bestVisited_;   // the best feasible label found so far
+    int                                             bestTime_;      // seconds
+    std::vector<Graph::edge_descriptor>             bestPath_;      // reversed path of the best label
+};
+
+// Visitor model, stops the search when the budget is exhausted and tracks the best label
+class GraphVisitor2 {
+public:
+    static constexpr size_t timeCheckPeriod_{ 64 };                 // loops between the time checks
+
+public:
+    explicit GraphVisitor2(GraphSearch2& search) noexcept : search_{ &search } {}
+
+    template <class Label>
+    void on_label_popped(const Label&, const Graph&) {}
+
+    template <class Label>
+    void on_label_feasible(const Label& label, const Graph&)
+    {
+        ++search_->labels_;
+        const GraphRC2& rc{ label.cumulated_resource_consumption };
+        search_->labelBytes_ += sizeof(Label) + rc.visited_.capacity() * sizeof(size_t);
+        // only routes through the 1st target are acceptable
+        if (rc.tgt0InPath_ == false || rc.visited_.size() < search_->bestVisited_.size()
+            || (rc.visited_.size() == search_->bestVisited_.size() && rc.time_ >= search_->bestTime_))
+        {
+            return;
+        }
+        search_->bestVisited_ = rc.visited_;
+        search_->bestTime_ = rc.time_;
+        search_->bestPath_.clear();
+        for (const Label* l = &label; l->num != 0; l = l->p_pred_label.get()) {
+            search_->bestPath_.push_back(l->pred_edge);
+        }
+    }
+
+    template <class Label>
+    void on_label_not_feasible(const Label&, const Graph&) { ++search_->labels_; }
+
+    template <class Label>
+    void on_label_dominated(const Label&, const Graph&) {}
+
+    template <class Label>
+    void on_label_not_dominated(const Label&, const Graph&) {}
+
+    template <class Queue>
+    bool on_enter_loop(const Queue&, const Graph&)
+    {
+        if (search_->labels_ >= search_->maxLabels_
+            || (search_->maxTime_.count() > 0 && ++search_->loops_ % timeCheckPeriod_ == 0
+                && std::chrono::steady_clock::now() - search_->start_ >= search_->maxTime_))
+        {
+            search_->complete_ = false;
+        }
+        return search_->complete_;
+    }
+
+private:
+    GraphSearch2*                                   search_;
+};
+
 
 struct MapPath {
     std::vector<Graph::edge_descriptor>     path_;
-    std::vector<size_t>                     visited_;           // indexes of visited vertices in 'tgtVertices_'
+    std::vector<size_t>                     visited_;           // indexes of visited vertices in 'targets_'
+    size_t                                  labels_;            // labels generated by the search
+    size_t                                  labelBytes_;        // approximate memory of the labels
+    bool                                    complete_;          // the search was not stopped by the budget
 };
 
 class Map {
 public:
     Map();
 
+    // grid of streets in both directions, the vertex 0 is at the corner
+    Map(size_t columns, size_t rows, int spacing);
+
     Map(const Map&) = delete;
     Map& operator=(const Map&) = delete;
 
@@ -154,6 +276,24 @@ public:
 
     const Graph& graph() const { return g_; }
 
+    // number of path searches, they allocate and are not a part of the steady state
+    unsigned long long int getNumberOfSearches() const noexcept
+    {
+        return searches_.load(std::memory_order_relaxed);
+    }
+
+    // total duration of the path searches, nanoseconds
+    long long int getSearchTime() const noexcept { return searchTime_.load(std::memory_order_relaxed); }
+
+    // number of route searches stopped by the time budget, their results depend on the machine
+    unsigned long long int getNumberOfTimeouts() const noexcept
+    {
+        return timeouts_.load(std::memory_order_relaxed);
+    }
+
+    // changes after every edit of the graph
+    unsigned long long int getVersion() const noexcept { return version_; }
+
 public:
     size_t addVertex(int x, int y);
 
@@ -163,38 +303,99 @@ public:
 
     void removeEdge(size_t srcVertex, size_t tgtVertex);
 
-    std::vector<Graph::edge_descriptor> getPath(size_t srcVertex, size_t tgtVertex);
+    // replaces the whole graph, the properties of the vertices and the edges are kept as they are
+    void setGraph(Graph&& graph);
+
+    // the searches are limited by the options of the simulation asking for the path
+    std::vector<Graph::edge_descriptor> getPath(size_t srcVertex, size_t tgtVertex,
+                                                const OptionsSimulation& options) const;
+
+    bool findPath(size_t srcVertex, size_t tgtVertex,
+                  std::vector<Graph::edge_descriptor>& path,
+                  const OptionsSimulation& options) const;
 
     MapPath getPath(const Graph::vertex_descriptor srcVertex,
-                    const std::vector<Graph::vertex_descriptor>& tgtVertices,
-                    const std::vector<std::chrono::seconds>& remainingTime);
+                    const std::vector<MapTarget>& targets,
+                    long long int currentTime,
+                    const OptionsSimulation& options) const;
+
+private:
+    static MapPath makePath(const std::vector<Graph::edge_descriptor>& reversedPath,
+                            std::vector<size_t>&& visited,
+                            const std::vector<MapTarget>& targets);
 
 private:
     Graph g_;
+    mutable std::atomic<unsigned long long int> searches_;  // the map can be shared by several threads
+    mutable std::atomic<long long int>          searchTime_;    // nanoseconds
+    mutable std::atomic<unsigned long long int> timeouts_;
+    unsigned long long int                      version_;
 };
 
 inline size_t Map::addVertex(int x, int y)
 {
+    ++version_;
     return boost::add_vertex(GraphVertexPropertyMap(g_.m_vertices.size(), x, y), g_);
 }
 
 inline void Map::removeVertex(size_t vertex)
 {
+    ++version_;
     boost::clear_vertex(vertex, g_);
     boost::remove_vertex(vertex, g_);
 }
 
 inline Graph::edge_descriptor Map::addEdge(size_t srcVertex, size_t tgtVertex, int distance)
 {
+    ++version_;
     return boost::add_edge(srcVertex, tgtVertex, GraphEdgePropertyMap(
         g_.m_edges.size(), distance, distance / OptionsCourier::defAverageSpeed_), g_).first;
 }
 
 inline void Map::removeEdge(size_t srcVertex, size_t tgtVertex)
 {
+    ++version_;
     boost::remove_edge(srcVertex, tgtVertex, g_);
 }
 
+inline void Map::setGraph(Graph&& graph)
+{
+    ++version_;
+    g_ = std::move(graph);
+}
+
+///************************************************************************************************
+
+// Paths between pairs of vertices, they are found once and dropped after an edit of the map;
+// the cache is not thread-safe, so every managment system has its own one
+class MapPathCache {
+public:
+    explicit MapPathCache(const Map& map);
+
+    MapPathCache(const MapPathCache&) = delete;
+    MapPathCache& operator=(const MapPathCache&) = delete;
+
+    virtual ~MapPathCache() noexcept {}
+
+public:
+    // nullptr if there is no path
+    const std::vector<Graph::edge_descriptor>* findPath(size_t srcVertex, size_t tgtVertex,
+                                                        const OptionsSimulation& options);
+
+private:
+    struct Entry {
+        bool                                    isFound_;
+        std::vector<Graph::edge_descriptor>     path_;
+    };
+
+private:
+    const Map&                                  map_;
+    std::unordered_map<unsigned long long int, Entry> paths_;   // the key is made of both vertices
+    const std::vector<Graph::edge_descriptor>   emptyPath_;
+    unsigned long long int                      version_;       // version of the map when the paths were found
+    int                                         deliveryTime_;  // the time limits the search, seconds
+};
+
 } // namespace ds
 
 #endif // !MAP_HPP
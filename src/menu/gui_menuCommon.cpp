@@ -5,10 +5,15 @@
 // (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
 
 #include"common.hpp"
+#include"generator.hpp"
 #include"gui_menuCommon.hpp"
 #include"options.hpp"
+#include"scheduler.hpp"
+#include"trace.hpp"
 #include<algorithm>
 #include<assert.h>
+#include<string_view>
+#include<utility>
 
 namespace ds {
 
@@ -73,6 +78,9 @@ void guiMenuBarOptions(ManagmentSystem& ms)
         if (ImGui::BeginMenu("Options")) {
             ImGuiIO& io{ ImGui::GetIO() };
             ImGui::Text("%.1f FPS (%.3f ms/frame)", io.Framerate, 1000.0f / io.Framerate);
+            if (cmn::isAllocationCounted) {
+                ImGui::Text("%llu allocations in the last update", ms.getAllocations());
+            }
             ImGui::SliderInt("Frames per second (FPS)",
                 &Options::instance().fps_, Options::minFPS_,
                 Options::maxFPS_, "%d", ImGuiSliderFlags_AlwaysClamp);
@@ -80,6 +88,24 @@ void guiMenuBarOptions(ManagmentSystem& ms)
                 &Options::instance().timeSpeed_, Options::minTimeSpeed_,
                 Options::maxTimeSpeed_, "%d", ImGuiSliderFlags_AlwaysClamp);
 
+            ImGui::Separator();
+            ImGui::TextUnformatted("Trace");
+            cmn::Tracer& tracer{ cmn::Tracer::instance() };
+            bool isTraced{ tracer.isEnabled() };
+            if (ImGui::Checkbox("Record trace", &isTraced)) {
+                if (isTraced) {
+                    tracer.start();
+                }
+                else {
+                    tracer.stop();
+                }
+            }
+            ImGui::Text("%llu transitions, %llu spans",
+                tracer.getNumberOfTransitions(), tracer.getNumberOfSpans());
+            if (ImGui::Button("Save trace")) {
+                tracer.write(u8"pizza-ds.trace.json");
+            }
+
             ImGui::Separator();
             ImGui::TextUnformatted("Map");
             ImGui::Checkbox("Show grid", &Options::instance().optMap_.showGrid_);
@@ -99,57 +125,147 @@ void guiMenuBarOptions(ManagmentSystem& ms)
                 OptionsMap::maxEdgeWidth_,
                 "%d", ImGuiSliderFlags_AlwaysClamp);
 
+            // the simulation options are published to the system only after an edit
+            bool isChanged{ false };
             ImGui::Separator();
             ImGui::TextUnformatted("Delivery");
-            ImGui::SliderInt("Delivery time (sec)##Delivery",
+            isChanged |= ImGui::SliderInt("Delivery time (sec)##Delivery",
                 &Options::instance().optDelivery_.deliveryTime_,
                 OptionsDelivery::minDeliveryTime_,
                 OptionsDelivery::maxDeliveryTime_,
                 "%d", ImGuiSliderFlags_AlwaysClamp);
-            ImGui::SliderInt("Time to check free couriers (sec)##Delivery",
+            isChanged |= ImGui::SliderInt("Time to check free couriers (sec)##Delivery",
                 &Options::instance().optDelivery_.checkTimeFreeCour_,
                 OptionsDelivery::minCheckTimeFreeCour_,
                 OptionsDelivery::maxCheckTimeFreeCour_,
                 "%d", ImGuiSliderFlags_AlwaysClamp);
+            isChanged |= ImGui::Checkbox("Add orders to routes being accepted##Delivery",
+                &Options::instance().optDelivery_.lateInsertion_);
+            isChanged |= ImGui::SliderInt("Route search labels##Delivery",
+                &Options::instance().optDelivery_.maxRouteLabels_,
+                OptionsDelivery::minMaxRouteLabels_,
+                OptionsDelivery::maxMaxRouteLabels_,
+                "%d", ImGuiSliderFlags_AlwaysClamp | ImGuiSliderFlags_Logarithmic);
+            isChanged |= ImGui::SliderInt("Route search time (ms, 0 - unlimited)##Delivery",
+                &Options::instance().optDelivery_.maxRouteTime_,
+                OptionsDelivery::minMaxRouteTime_,
+                OptionsDelivery::maxMaxRouteTime_,
+                "%d", ImGuiSliderFlags_AlwaysClamp | ImGuiSliderFlags_Logarithmic);
 
             ImGui::Separator();
             ImGui::TextUnformatted("Courier");
-            ImGui::SliderInt("Courier pause time (sec)##Courier",
+            isChanged |= ImGui::SliderInt("Courier pause time (sec)##Courier",
                 &Options::instance().optCourier_.pauseTime_,
                 OptionsCourier::minPauseTime_,
                 OptionsCourier::maxPauseTime_,
                 "%d", ImGuiSliderFlags_AlwaysClamp);
-            ImGui::SliderInt("Courier pause chance (%)##Courier",
+            isChanged |= ImGui::SliderInt("Courier pause chance (%)##Courier",
                 &Options::instance().optCourier_.pauseChance_,
                 OptionsCourier::minPauseChance_,
                 OptionsCourier::maxPauseChance_,
                 "%d", ImGuiSliderFlags_AlwaysClamp);
-            ImGui::SliderInt("Order acceptance time (sec)##Courier",
+            isChanged |= ImGui::SliderInt("Order acceptance time (sec)##Courier",
                 &Options::instance().optCourier_.acceptanceTime_,
                 OptionsCourier::minAcceptanceTime_,
                 OptionsCourier::maxAcceptanceTime_,
                 "%d", ImGuiSliderFlags_AlwaysClamp);
-            ImGui::SliderInt("Delivery time (sec)##Courier",
+            isChanged |= ImGui::SliderInt("Delivery time (sec)##Courier",
                 &Options::instance().optCourier_.deliveryTime_,
                 OptionsCourier::minDeliveryTime_,
                 OptionsCourier::maxDeliveryTime_,
                 "%d", ImGuiSliderFlags_AlwaysClamp);
-            ImGui::SliderInt("Payment time (sec)##Courier",
+            isChanged |= ImGui::SliderInt("Payment time (sec)##Courier",
                 &Options::instance().optCourier_.paymentTime_,
                 OptionsCourier::minPaymentTime_,
                 OptionsCourier::maxPaymentTime_,
                 "%d", ImGuiSliderFlags_AlwaysClamp);
-            ImGui::SliderInt("Average courier speed (meters per second)##Courier",
+            isChanged |= ImGui::SliderInt("Average courier speed (meters per second)##Courier",
                 &Options::instance().optCourier_.averageSpeed_,
                 OptionsCourier::minAverageSpeed_,
                 OptionsCourier::maxAverageSpeed_,
                 "%d", ImGuiSliderFlags_AlwaysClamp);
 
+            ImGui::Separator();
+            ImGui::TextUnformatted("Order generator");
+            for (char i = 0; i < cmn::numberOf<ArrivalProfile>(); ++i) {
+                const ArrivalProfile profile{ i };
+                if (i > 0) {
+                    ImGui::SameLine();
+                }
+                GuiText label;
+                label.append(toString(profile)).append(u8"##Generator");
+                isChanged |= ImGui::RadioButton(label.c_str(), &Options::instance().optGenerator_.profile_, i);
+            }
+            isChanged |= ImGui::SliderInt("Orders per hour##Generator",
+                &Options::instance().optGenerator_.orderRate_,
+                OptionsGenerator::minOrderRate_,
+                OptionsGenerator::maxOrderRate_,
+                "%d", ImGuiSliderFlags_AlwaysClamp | ImGuiSliderFlags_Logarithmic);
+            isChanged |= ImGui::SliderInt("Hour of the day at the start##Generator",
+                &Options::instance().optGenerator_.startHour_,
+                OptionsGenerator::minStartHour_,
+                OptionsGenerator::maxStartHour_,
+                "%d", ImGuiSliderFlags_AlwaysClamp);
+            isChanged |= ImGui::SliderInt("Burst factor##Generator",
+                &Options::instance().optGenerator_.burstFactor_,
+                OptionsGenerator::minBurstFactor_,
+                OptionsGenerator::maxBurstFactor_,
+                "%d", ImGuiSliderFlags_AlwaysClamp);
+            isChanged |= ImGui::SliderInt("Number of hotspots##Generator",
+                &Options::instance().optGenerator_.numHotspots_,
+                OptionsGenerator::minNumHotspots_,
+                OptionsGenerator::maxNumHotspots_,
+                "%d", ImGuiSliderFlags_AlwaysClamp);
+            isChanged |= ImGui::SliderInt("Orders to hotspots (%)##Generator",
+                &Options::instance().optGenerator_.hotspotShare_,
+                OptionsGenerator::minHotspotShare_,
+                OptionsGenerator::maxHotspotShare_,
+                "%d", ImGuiSliderFlags_AlwaysClamp);
+
+            if (isChanged) {
+                Options::instance().isChanged_ = true;
+            }
+
+            ImGui::EndMenu();
+        }
+
+        if (ImGui::BeginMenu("Orders")) {
+            for (char i = 0; i < cmn::numberOf<OrderStatus>(); ++i) {
+                const OrderStatus status{ i };
+                GuiText text;
+                text.append(toString(status)).append(u8": ").append(ms.orderTable().countStatus(status));
+                ImGui::TextUnformatted(text.c_str());
+            }
+            ImGui::EndMenu();
+        }
+
+        if (ImGui::BeginMenu("Latency")) {
+            auto showLine{ [](string_view name, const cmn::Histogram& histogram) {
+                GuiText text;
+                text.append(name);
+                const pair<const char*, double> percentiles[]{
+                    { u8": p50 ", 50.0 }, { u8", p90 ", 90.0 }, { u8", p99 ", 99.0 }, { u8", p99.9 ", 99.9 }
+                };
+                for (const auto& [prefix, percentile] : percentiles) {
+                    text.append(prefix)
+                        .appendDuration(cmn::toDuration(cmn::tick_t(histogram.getPercentile(percentile))));
+                }
+                ImGui::TextUnformatted(text.c_str());
+            } };
+            const Scheduler& scheduler{ ms.scheduler() };
+            ImGui::Text("%llu completed orders", scheduler.getTotalLatency().getCount());
+            for (char i = 0; i < cmn::numberOf<OrderPhase>(); ++i) {
+                const OrderPhase phase{ i };
+                showLine(toString(phase), scheduler.getLatency(phase));
+            }
+            showLine(u8"Total", scheduler.getTotalLatency());
             ImGui::EndMenu();
         }
 
         ImGui::SameLine(0.0f, 50.0f);
-        ImGui::TextUnformatted(cmn::getTime(ms.getCurrentTime()).c_str());
+        GuiText time;
+        time.appendTime(ms.getCurrentTime());
+        ImGui::TextUnformatted(time.c_str());
 
         ImGui::EndMenuBar();
     }
@@ -7,6 +7,7 @@
 #ifndef GUI_MENU_COMMON_HPP
 #define GUI_MENU_COMMON_HPP
 
+#include"format.hpp"
 #include"imgui.h"
 #include"msystem.hpp"
 
@@ -87,6 +88,11 @@ private:
 
 ///************************************************************************************************
 
+// text of a row of a list or of a tooltip, one buffer is reused for all rows of a frame
+using GuiText = cmn::TextBuffer<1024>;
+
+///************************************************************************************************
+
 void guiCommonInitialization(ImGuiWindowFlags& window_flags);
 
 ///************************************************************************************************
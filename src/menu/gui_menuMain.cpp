@@ -14,7 +14,6 @@
 #include<iterator>
 #include<limits>
 #include<regex>
-#include<sstream>
 
 namespace ds {
 
@@ -111,10 +110,9 @@ void guiMenuCommon(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
 {
     ImGuiWindowFlags window_flags{ 0 };
     guiCommonInitialization(window_flags);
-    string s;
+    GuiText text;
 
-    s = string{ u8"Common" } + u8"###MenuCommon";
-    if (ImGui::Begin(s.c_str(), nullptr, window_flags)) {
+    if (ImGui::Begin(u8"Common###MenuCommon", nullptr, window_flags)) {
         guiMenuBarOptions(ms);
 
         guiMenuMain_Submenu(submenu);
@@ -143,10 +141,9 @@ void guiMenuCommon(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
             if (ImGui::BeginListBox("Cooking orders", ImVec2(-FLT_MIN, -FLT_MIN))) {
                 auto cookOrders{ ms.kitchen().getOrders() };
                 for (auto iter{ cookOrders.first }; iter != cookOrders.second; ++iter) {
-                    ostringstream oss;
-                    oss << setw(width) << setfill(filler) << cmn::toUnderlying((*iter)->getID())
-                        << " - " << toString((*iter)->getStatus());
-                    ImGui::TextUnformatted(oss.str().c_str());
+                    text.clear().append(cmn::toUnderlying((*iter)->getID()), width, filler)
+                        .append(u8" - ").append(toString((*iter)->getStatus()));
+                    ImGui::TextUnformatted(text.c_str());
                 }
                 ImGui::EndListBox();
             }
@@ -169,10 +166,9 @@ void guiMenuCommon(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
             if (ImGui::BeginListBox("Delivery orders", ImVec2(-FLT_MIN, -FLT_MIN))) {
                 auto delivOrders{ ms.delivery().getOrders() };
                 for (auto iter{ delivOrders.first }; iter != delivOrders.second; ++iter) {
-                    ostringstream oss;
-                    oss << setw(width) << setfill(filler) << cmn::toUnderlying((*iter)->getID())
-                        << " - " << toString((*iter)->getStatus());
-                    ImGui::TextUnformatted(oss.str().c_str());
+                    text.clear().append(cmn::toUnderlying((*iter)->getID()), width, filler)
+                        .append(u8" - ").append(toString((*iter)->getStatus()));
+                    ImGui::TextUnformatted(text.c_str());
                 }
                 ImGui::EndListBox();
             }
@@ -197,14 +193,13 @@ void guiMenuCommon(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
                 boost::circular_buffer<Order*>::const_iterator iter{ complOrders.second };
                 while (iter != complOrders.first) {
                     --iter;
-                    ostringstream oss;
-                    oss << setw(width) << setfill(filler) << cmn::toUnderlying((*iter)->getID())
-                        << " - " << toString((*iter)->getStatus());
+                    text.clear().append(cmn::toUnderlying((*iter)->getID()), width, filler)
+                        .append(u8" - ").append(toString((*iter)->getStatus()));
                     if ((*iter)->getStatus() == OrderStatus::COMPLETED) {
-                        oss << " in "
-                            << cmn::getDuration((*iter)->getTimeEnd() - (*iter)->getTimeStart());
+                        text.append(u8" in ")
+                            .appendDuration(cmn::toDuration((*iter)->getTimeEnd() - (*iter)->getTimeStart()));
                     }
-                    ImGui::TextUnformatted(oss.str().c_str());
+                    ImGui::TextUnformatted(text.c_str());
                 }
                 ImGui::EndListBox();
             }
@@ -227,10 +222,9 @@ void guiMenuKitchen(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
 {
     ImGuiWindowFlags window_flags{ 0 };
     guiCommonInitialization(window_flags);
-    string s;
+    GuiText text;
 
-    s = string{ u8"Kitchen" } + u8"###MenuKitchen";
-    if (ImGui::Begin(s.c_str(), nullptr, window_flags)) {
+    if (ImGui::Begin(u8"Kitchen###MenuKitchen", nullptr, window_flags)) {
         guiMenuBarOptions(ms);
 
         guiMenuMain_Submenu(submenu);
@@ -258,10 +252,12 @@ void guiMenuKitchen(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
             if (ImGui::BeginListBox("Cooking orders", ImVec2(-FLT_MIN, -FLT_MIN))) {
                 auto cookOrders{ ms.kitchen().getOrders() };
                 for (auto iter{ cookOrders.first }; iter != cookOrders.second; ++iter) {
-                    ostringstream oss;
-                    oss << setw(width) << setfill(filler) << cmn::toUnderlying((*iter)->getID())
-                        << " - " << toString((*iter)->getStatus());
-                    ImGui::TextUnformatted(oss.str().c_str());
+                    text.clear().append(cmn::toUnderlying((*iter)->getID()), width, filler)
+                        .append(u8" - ").append(toString((*iter)->getStatus()));
+                    if ((*iter)->getReadyTime() != cmn::maxTick) {
+                        text.append(u8" - ready at ").appendTime(ms.getTime((*iter)->getReadyTime()));
+                    }
+                    ImGui::TextUnformatted(text.c_str());
                 }
                 ImGui::EndListBox();
             }
@@ -284,9 +280,9 @@ void guiMenuKitchen(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
             if (ImGui::BeginListBox("Dough queue", ImVec2(-FLT_MIN, -FLT_MIN))) {
                 auto foodQueueDough{ ms.kitchen().getQueueDough() };
                 for (auto iter{ foodQueueDough.first }; iter != foodQueueDough.second; ++iter) {
-                    ostringstream oss;
-                    oss << toString((*iter)->getName()) << " - " << toString((*iter)->getStatus());
-                    ImGui::TextUnformatted(oss.str().c_str());
+                    text.clear().append(toString((*iter)->getName()))
+                        .append(u8" - ").append(toString((*iter)->getStatus()));
+                    ImGui::TextUnformatted(text.c_str());
                 }
                 ImGui::EndListBox();
             }
@@ -309,9 +305,9 @@ void guiMenuKitchen(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
             if (ImGui::BeginListBox("Filling queue", ImVec2(-FLT_MIN, -FLT_MIN))) {
                 auto foodQueueFilling{ ms.kitchen().getQueueFilling() };
                 for (auto iter{ foodQueueFilling.first }; iter != foodQueueFilling.second; ++iter) {
-                    ostringstream oss;
-                    oss << toString((*iter)->getName()) << " - " << toString((*iter)->getStatus());
-                    ImGui::TextUnformatted(oss.str().c_str());
+                    text.clear().append(toString((*iter)->getName()))
+                        .append(u8" - ").append(toString((*iter)->getStatus()));
+                    ImGui::TextUnformatted(text.c_str());
                 }
                 ImGui::EndListBox();
             }
@@ -334,9 +330,9 @@ void guiMenuKitchen(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
             if (ImGui::BeginListBox("Picker queue", ImVec2(-FLT_MIN, -FLT_MIN))) {
                 auto foodQueuePicker{ ms.kitchen().getQueuePicker() };
                 for (auto iter{ foodQueuePicker.first }; iter != foodQueuePicker.second; ++iter) {
-                    ostringstream oss;
-                    oss << toString((*iter)->getName()) << " - " << toString((*iter)->getStatus());
-                    ImGui::TextUnformatted(oss.str().c_str());
+                    text.clear().append(toString((*iter)->getName()))
+                        .append(u8" - ").append(toString((*iter)->getStatus()));
+                    ImGui::TextUnformatted(text.c_str());
                 }
                 ImGui::EndListBox();
             }
@@ -361,19 +357,18 @@ void guiMenuKitchen(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
             ImGui::TextUnformatted("Kitcheners");
             if (ImGui::BeginListBox("Kitcheners", ImVec2(-FLT_MIN, -FLT_MIN))) {
                 for (auto iter{ kitcheners.first }; iter != kitcheners.second; ++iter) {
-                    ostringstream oss;
                     const auto kitchener{ iter->get() };
-                    oss << "ID: " << setw(width) << setfill(filler)
-                        << cmn::toUnderlying(kitchener->getID())
-                        << " - " << toString(kitchener->getType())
-                        << " - " << toString(kitchener->getStatus());
+                    text.clear().append(u8"ID: ")
+                        .append(cmn::toUnderlying(kitchener->getID()), width, filler)
+                        .append(u8" - ").append(toString(kitchener->getType()))
+                        .append(u8" - ").append(toString(kitchener->getStatus()));
                     const auto food{ kitchener->getFood() };
                     if (food != nullptr) {
-                        oss << " (" << toString(food->getName())
-                            << " - OrderID: "
-                            << cmn::toUnderlying(ms.kitchen().getOrder(food).getID()) << ")";
+                        text.append(u8" (").append(toString(food->getName()))
+                            .append(u8" - OrderID: ")
+                            .append(cmn::toUnderlying(ms.kitchen().getOrder(food).getID())).append(')');
                     }
-                    ImGui::TextUnformatted(oss.str().c_str());
+                    ImGui::TextUnformatted(text.c_str());
                 }
                 ImGui::EndListBox();
             }
@@ -390,10 +385,9 @@ void guiMenuDelivery(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
 {
     ImGuiWindowFlags window_flags{ 0 };
     guiCommonInitialization(window_flags);
-    string s;
+    GuiText text;
 
-    s = string{ u8"Delivery" } + u8"###MenuDelivery";
-    if (ImGui::Begin(s.c_str(), nullptr, window_flags)) {
+    if (ImGui::Begin(u8"Delivery###MenuDelivery", nullptr, window_flags)) {
         guiMenuBarOptions(ms);
 
         guiMenuMain_Submenu(submenu);
@@ -421,10 +415,12 @@ void guiMenuDelivery(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
             if (ImGui::BeginListBox("Delivery orders", ImVec2(-FLT_MIN, -FLT_MIN))) {
                 auto delivOrders{ ms.delivery().getOrders() };
                 for (auto iter{ delivOrders.first }; iter != delivOrders.second; ++iter) {
-                    ostringstream oss;
-                    oss << setw(width) << setfill(filler) << cmn::toUnderlying((*iter)->getID())
-                        << " - " << toString((*iter)->getStatus());
-                    ImGui::TextUnformatted(oss.str().c_str());
+                    text.clear().append(cmn::toUnderlying((*iter)->getID()), width, filler)
+                        .append(u8" - ").append(toString((*iter)->getStatus()));
+                    if ((*iter)->getReadyTime() != cmn::maxTick) {
+                        text.append(u8" - ready at ").appendTime(ms.getTime((*iter)->getReadyTime()));
+                    }
+                    ImGui::TextUnformatted(text.c_str());
                 }
                 ImGui::EndListBox();
             }
@@ -451,14 +447,13 @@ void guiMenuDelivery(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
                 boost::circular_buffer<Order*>::const_iterator iter{ complOrders.second };
                 while (iter != complOrders.first) {
                     --iter;
-                    ostringstream oss;
-                    oss << setw(width) << setfill(filler) << cmn::toUnderlying((*iter)->getID())
-                        << " - " << toString((*iter)->getStatus());
+                    text.clear().append(cmn::toUnderlying((*iter)->getID()), width, filler)
+                        .append(u8" - ").append(toString((*iter)->getStatus()));
                     if ((*iter)->getStatus() == OrderStatus::COMPLETED) {
-                        oss << " in "
-                            << cmn::getDuration((*iter)->getTimeEnd() - (*iter)->getTimeStart());
+                        text.append(u8" in ")
+                            .appendDuration(cmn::toDuration((*iter)->getTimeEnd() - (*iter)->getTimeStart()));
                     }
-                    ImGui::TextUnformatted(oss.str().c_str());
+                    ImGui::TextUnformatted(text.c_str());
                 }
                 ImGui::EndListBox();
             }
@@ -483,20 +478,19 @@ void guiMenuDelivery(bool* open, ManagmentSystem& ms, SubmenuType& submenu)
             ImGui::TextUnformatted("Couriers");
             if (ImGui::BeginListBox("Couriers", ImVec2(-FLT_MIN, -FLT_MIN))) {
                 for (auto iter{ couriers.first }; iter != couriers.second; ++iter) {
-                    ostringstream oss;
                     const auto courier{ iter->get() };
                     const auto status{ courier->getStatus() };
-                    oss << "ID: " << setw(width) << setfill(filler)
-                        << cmn::toUnderlying(courier->getID())
-                        << " - " << toString(status);
+                    text.clear().append(u8"ID: ")
+                        .append(cmn::toUnderlying(courier->getID()), width, filler)
+                        .append(u8" - ").append(toString(status));
                     if (status == CourierStatus::MOVEMENT_TO_CUSTOMER ||
                         status == CourierStatus::DELIVERY_AND_PAYMENT)
                     {
                         const auto curOrder{ courier->getCurrentOrder() };
-                        oss << " (OrderID: "
-                            << cmn::toUnderlying((*curOrder)->getID()) << ")";
+                        text.append(u8" (OrderID: ")
+                            .append(cmn::toUnderlying((*curOrder)->getID())).append(')');
                     }
-                    ImGui::TextUnformatted(oss.str().c_str());
+                    ImGui::TextUnformatted(text.c_str());
                 }
                 ImGui::EndListBox();
             }
@@ -566,25 +560,24 @@ void guiMap(ManagmentSystem& ms, GuiMapData& mapData)
             ImGui::SetCursorScreenPos(screenPos);
             ImGui::InvisibleButton(u8"v", invButtonSize,
                 ImGuiButtonFlags_MouseButtonLeft | ImGuiButtonFlags_MouseButtonRight);
-            // vertex description
-            ostringstream oss;
-            oss << u8"Vertex " << i << endl
-                << u8"Coordinates X,Y: " << vertices[i].m_property.x_ << ','
-                << vertices[i].m_property.y_ << endl;
-            for (int j = 0; j < vertices[i].m_out_edges.size(); ++j) {
-                oss << u8"Edge " << j << u8" (distance,time): " << i << u8" -> "
-                    << vertices[i].m_out_edges[j].m_target
-                    << u8" (" << vertices[i].m_out_edges[j].get_property().distance_
-                    << ',' << vertices[i].m_out_edges[j].get_property().time_ << ')' << endl;
-            }
             // if vertex is hovered, show description
             if (ImGui::IsItemHovered()) {
                 vertexCur = i;
                 isHoveredVertexCur = true;
 
+                GuiText text;
+                text.append(u8"Vertex ").append(i).append('\n')
+                    .append(u8"Coordinates X,Y: ").append(vertices[i].m_property.x_).append(',')
+                    .append(vertices[i].m_property.y_).append('\n');
+                for (int j = 0; j < vertices[i].m_out_edges.size(); ++j) {
+                    text.append(u8"Edge ").append(j).append(u8" (distance,time): ").append(i).append(u8" -> ")
+                        .append(vertices[i].m_out_edges[j].m_target)
+                        .append(u8" (").append(vertices[i].m_out_edges[j].get_property().distance_)
+                        .append(',').append(vertices[i].m_out_edges[j].get_property().time_).append(u8")\n");
+                }
                 ImGui::BeginTooltip();
                 ImGui::PushTextWrapPos(ImGui::GetFontSize() * 35.0f);
-                ImGui::TextUnformatted(oss.str().c_str());
+                ImGui::TextUnformatted(text.c_str());
                 ImGui::PopTextWrapPos();
                 ImGui::EndTooltip();
             }
@@ -651,9 +644,9 @@ void guiMap(ManagmentSystem& ms, GuiMapData& mapData)
 
     // context menu
     if (ImGui::BeginPopup(u8"ContextCanvasPopup")) {
-        ostringstream oss;
-        oss << u8"Coordinates X,Y: " << vertexPos.x << ',' << vertexPos.y;
-        ImGui::TextUnformatted(oss.str().c_str());
+        GuiText text;
+        text.append(u8"Coordinates X,Y: ").append(vertexPos.x).append(',').append(vertexPos.y);
+        ImGui::TextUnformatted(text.c_str());
         ImGui::Separator();
         if (ImGui::MenuItem(u8"Add vertex here")) {
             ms.map().addVertex(vertexPos.x, vertexPos.y);
@@ -672,10 +665,10 @@ void guiMap(ManagmentSystem& ms, GuiMapData& mapData)
         }
         if (ImGui::BeginMenu(u8"Remove edge")) {
             for (int i = 0; i < vertices[vertex].m_out_edges.size(); ++i) {
-                ostringstream oss;
-                oss << u8"Remove edge " << i << u8": " << vertex << u8" -> "
-                    << vertices[vertex].m_out_edges[i].m_target;
-                if (ImGui::MenuItem(oss.str().c_str())) {
+                GuiText text;
+                text.append(u8"Remove edge ").append(i).append(u8": ").append(vertex).append(u8" -> ")
+                    .append(vertices[vertex].m_out_edges[i].m_target);
+                if (ImGui::MenuItem(text.c_str())) {
                     ms.map().removeEdge(vertex, vertices[vertex].m_out_edges[i].m_target);
                 }
             }
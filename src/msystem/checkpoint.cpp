@@ -0,0 +1,828 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"checkpoint.hpp"
+#include"eventlog.hpp"
+#include"options.hpp"
+#include<algorithm>
+#include<array>
+#include<assert.h>
+#include<cstring>
+#include<fstream>
+#include<iterator>
+#include<limits>
+#include<memory>
+#include<numeric>
+#include<type_traits>
+#include<unordered_map>
+#include<vector>
+
+namespace ds {
+
+using namespace std;
+
+namespace {
+
+constexpr char checkpointMagic[8]{ 'P', 'Z', 'D', 'S', 'C', 'K', 'P', '\0' };
+
+constexpr unsigned long long int none{ numeric_limits<unsigned long long int>::max() };
+
+// sections of the records after the header, in the order of the file
+enum Section : size_t {
+    VERTICES,
+    EDGES,                                      // the out-edges of each vertex in turn
+    ORDERS,
+    KITCHENERS,
+    COURIERS,
+    ROUTE_ORDERS,                               // the routes of the couriers in turn
+    ROUTE_EDGES,
+    KITCHEN_ORDERS,
+    KITCHEN_QUEUES,                             // one section for each type of the kitcheners
+    FREE_TIMES = KITCHEN_QUEUES + cmn::numberOf<KitchenerType>(),
+    DELIVERY_ORDERS = FREE_TIMES + cmn::numberOf<KitchenerType>(),
+    DELIVERY_QUEUE,
+    DELIVERY_TARGETS,
+    COMPLETED_ORDERS,
+    RANDOM_STATE,                               // seed of the engine drawn at the write
+    NUMBER_OF_SECTIONS
+};
+
+// the records have no padding, so the same state is always written to the same bytes;
+// an order is referred to by its index, a food by the index of its order and its index in the order
+
+struct Header {
+    char                                        magic_[8];
+    unsigned long long int                      version_;
+    unsigned long long int                      sizes_[NUMBER_OF_SECTIONS]; // number of records in each section
+    cmn::tick_t                                 tick_;
+    long long int                               startTime_;     // wall clock of the tick 0, nanoseconds since the epoch
+    unsigned long long int                      nextOrderID_;
+    unsigned long long int                      orderIDStep_;
+    unsigned long long int                      office_;
+    long long int                               checkTime_;     // of the free couriers, nanoseconds
+    unsigned long long int                      routedOrders_;
+    option_values_t                             options_;
+    int                                         reserved_;
+};
+
+struct VertexRecord {
+    int                                         num_;
+    int                                         x_;
+    int                                         y_;
+};
+
+struct EdgeRecord {
+    unsigned long long int                      source_;
+    unsigned long long int                      target_;
+    int                                         num_;
+    int                                         distance_;
+    int                                         time_;
+    int                                         reserved_;
+};
+
+struct FoodRecord {
+    unsigned short                              qty_;
+    FoodName                                    name_;
+    FoodStatus                                  status_;
+};
+
+struct OrderRecord {
+    OrderID                                     id_;
+    unsigned long long int                      target_;
+    cmn::tick_t                                 timeStart_;
+    cmn::tick_t                                 timeEnd_;
+    cmn::tick_t                                 readyTime_;
+    std::array<cmn::tick_t, cmn::numberOf<OrderPhase>()> phaseStart_;
+    FoodRecord                                  food_[Order::maxFood_];
+    OrderStatus                                 status_;
+    unsigned char                               isPaid_;
+    unsigned char                               numFood_;
+    unsigned char                               reserved_[5];
+};
+
+struct KitchenerRecord {
+    unsigned long long int                      food_;          // 'none' if there is no food
+    unsigned long long int                      batch_;         // position in the batch of the status
+    unsigned long long int                      idle_;          // position among the idle kitcheners of the type, 'none' if not idle
+    long long int                               passedTime_;    // nanoseconds
+    long long int                               makingTime_;
+    WorkerID                                    id_;
+    KitchenerType                               type_;
+    KitchenerStatus                             status_;
+    KitchenerStatus                             prevStatus_;
+    unsigned char                               reserved_;
+};
+
+struct CourierRecord {
+    unsigned long long int                      batch_;         // position in the batch of the status
+    unsigned long long int                      routeOrders_;   // number of records of the route
+    unsigned long long int                      routeEdges_;
+    unsigned long long int                      curOrder_;      // index in the route, 'none' if not set
+    unsigned long long int                      curEdge_;
+    long long int                               passedTime_;    // nanoseconds
+    long long int                               makingTime_;
+    long long int                               passedDist_;    // nanometers
+    long long int                               fullDist_;
+    float                                       x_;
+    float                                       y_;
+    WorkerID                                    id_;
+    CourierStatus                               status_;
+    CourierStatus                               prevStatus_;
+    unsigned char                               hasRoute_;
+    unsigned char                               reserved_;
+};
+
+// the edge is found among the out-edges of its source by the index
+struct EdgeReference {
+    unsigned long long int                      source_;
+    unsigned long long int                      index_;
+};
+
+static_assert(sizeof(Header) == 8 * (2 + NUMBER_OF_SECTIONS + 7) + sizeof(option_values_t) + sizeof(int));
+static_assert(sizeof(VertexRecord) == 12);
+static_assert(sizeof(EdgeRecord) == 32);
+static_assert(sizeof(OrderRecord) == 104);
+static_assert(sizeof(KitchenerRecord) == 48);
+static_assert(sizeof(CourierRecord) == 88);
+static_assert(sizeof(EdgeReference) == 16);
+static_assert(sizeof(MapTarget) == 16);
+
+constexpr size_t getRecordSize(size_t section) noexcept
+{
+    switch (section) {
+    case VERTICES:
+        return sizeof(VertexRecord);
+    case EDGES:
+        return sizeof(EdgeRecord);
+    case ORDERS:
+        return sizeof(OrderRecord);
+    case KITCHENERS:
+        return sizeof(KitchenerRecord);
+    case COURIERS:
+        return sizeof(CourierRecord);
+    case ROUTE_EDGES:
+        return sizeof(EdgeReference);
+    case DELIVERY_TARGETS:
+        return sizeof(MapTarget);
+    default:
+        return section >= FREE_TIMES && section < DELIVERY_ORDERS ? sizeof(cmn::tick_t)
+                                                                   : sizeof(unsigned long long int);
+    }
+}
+
+// the current order of the courier is set in these statuses, the current edge also while returning
+bool hasCurrentOrder(CourierStatus status) noexcept
+{
+    return status == CourierStatus::ACCEPTING_ORDER
+        || status == CourierStatus::MOVEMENT_TO_CUSTOMER
+        || status == CourierStatus::DELIVERY_AND_PAYMENT;
+}
+
+bool hasCurrentEdge(CourierStatus status) noexcept
+{
+    return hasCurrentOrder(status) || status == CourierStatus::RETURNING_TO_OFFICE;
+}
+
+///************************************************************************************************
+
+class SectionWriter {
+public:
+    template <class T>
+    void add(Section section, const T& record)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        assert(sizeof(T) == getRecordSize(section));
+        const auto* bytes{ reinterpret_cast<const unsigned char*>(&record) };
+        sections_[section].insert(sections_[section].end(), bytes, bytes + sizeof(T));
+    }
+
+    bool write(Header& header, const string& fileName) const
+    {
+        for (size_t i = 0; i < NUMBER_OF_SECTIONS; ++i) {
+            header.sizes_[i] = sections_[i].size() / getRecordSize(i);
+        }
+        ofstream file{ fileName, ios::binary };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        for (const auto& section : sections_) {
+            file.write(reinterpret_cast<const char*>(section.data()), streamsize(section.size()));
+        }
+        file.close();
+        return file.fail() == false;
+    }
+
+private:
+    std::array<vector<unsigned char>, NUMBER_OF_SECTIONS> sections_{};
+};
+
+// the records are copied out of the data, so the sections need no alignment
+class SectionReader {
+public:
+    explicit SectionReader(const vector<unsigned char>& data) noexcept
+        :
+        data_       { data },
+        offsets_    {},
+        sizes_      {}
+    {}
+
+    // returns false if the sections do not fill the data exactly
+    bool open(const Header& header) noexcept
+    {
+        size_t offset{ sizeof(Header) };
+        for (size_t i = 0; i < NUMBER_OF_SECTIONS; ++i) {
+            if (header.sizes_[i] > (data_.size() - offset) / getRecordSize(i)) {
+                return false;
+            }
+            offsets_[i] = offset;
+            sizes_[i] = size_t(header.sizes_[i]);
+            offset += sizes_[i] * getRecordSize(i);
+        }
+        return offset == data_.size();
+    }
+
+    size_t getSize(Section section) const noexcept { return sizes_[section]; }
+
+    template <class T>
+    T get(Section section, size_t index) const noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        assert(sizeof(T) == getRecordSize(section) && index < sizes_[section]);
+        T record;
+        memcpy(&record, data_.data() + offsets_[section] + index * sizeof(T), sizeof(T));
+        return record;
+    }
+
+private:
+    const vector<unsigned char>&                data_;
+    std::array<size_t, NUMBER_OF_SECTIONS>      offsets_;
+    std::array<size_t, NUMBER_OF_SECTIONS>      sizes_;
+};
+
+///************************************************************************************************
+
+EdgeReference getEdgeReference(const Graph& graph, const Graph::edge_descriptor& edge)
+{
+    unsigned long long int index{ 0 };
+    for (auto [iter, end]{ boost::out_edges(edge.m_source, graph) }; iter != end; ++iter, ++index) {
+        if (*iter == edge) {
+            return EdgeReference{ edge.m_source, index };
+        }
+    }
+    assert(false);
+    return EdgeReference{ edge.m_source, none };
+}
+
+// the positions of the workers in their lists are distinct and fill the lists
+class PositionCheck {
+public:
+    explicit PositionCheck(size_t numLists) : counts_(numLists, 0), isTaken_(numLists) {}
+
+    void count(size_t list) { ++counts_[list]; }
+
+    bool take(size_t list, unsigned long long int position)
+    {
+        if (isTaken_[list].empty()) {
+            isTaken_[list].resize(counts_[list], false);
+        }
+        if (position >= isTaken_[list].size() || isTaken_[list][size_t(position)]) {
+            return false;
+        }
+        isTaken_[list][size_t(position)] = true;
+        return true;
+    }
+
+private:
+    vector<size_t>                              counts_;
+    vector<vector<bool>>                        isTaken_;
+};
+
+// the indices of the records are checked, so the restore never reads out of the sections;
+// a checkpoint written by 'Checkpoint::write' is consistent otherwise
+bool isValid(const SectionReader& reader, const Header& header)
+{
+    const size_t numVertices{ reader.getSize(VERTICES) };
+    if (header.office_ >= numVertices || header.orderIDStep_ == 0) {
+        return false;
+    }
+    // the edges are grouped by the source, the route edges are found by the index among them
+    vector<size_t> firstEdge(numVertices + 1, 0);
+    for (size_t i = 0; i < reader.getSize(EDGES); ++i) {
+        const EdgeRecord edge{ reader.get<EdgeRecord>(EDGES, i) };
+        if (edge.source_ >= numVertices || edge.target_ >= numVertices
+            || (i > 0 && edge.source_ < reader.get<EdgeRecord>(EDGES, i - 1).source_))
+        {
+            return false;
+        }
+        ++firstEdge[size_t(edge.source_) + 1];
+    }
+    partial_sum(firstEdge.cbegin(), firstEdge.cend(), firstEdge.begin());
+
+    const size_t numOrders{ reader.getSize(ORDERS) };
+    vector<unsigned char> numFood(numOrders, 0);
+    for (size_t i = 0; i < numOrders; ++i) {
+        const OrderRecord order{ reader.get<OrderRecord>(ORDERS, i) };
+        if (order.target_ >= numVertices || order.numFood_ > Order::maxFood_
+            || cmn::isValidEnum(order.status_) == false)
+        {
+            return false;
+        }
+        for (size_t f = 0; f < order.numFood_; ++f) {
+            if (cmn::isValidEnum(order.food_[f].name_) == false
+                || cmn::isValidEnum(order.food_[f].status_) == false)
+            {
+                return false;
+            }
+        }
+        numFood[i] = order.numFood_;
+    }
+    auto isOrder{ [numOrders](unsigned long long int ref) { return ref < numOrders; } };
+    auto isFood{ [&numFood, numOrders](unsigned long long int ref) {
+        return ref / Order::maxFood_ < numOrders && ref % Order::maxFood_ < numFood[size_t(ref / Order::maxFood_)];
+    } };
+    auto areRefs{ [&reader](Section section, auto isRef) {
+        for (size_t i = 0; i < reader.getSize(section); ++i) {
+            if (isRef(reader.get<unsigned long long int>(section, i)) == false) {
+                return false;
+            }
+        }
+        return true;
+    } };
+
+    const size_t numKitcheners{ reader.getSize(KITCHENERS) };
+    PositionCheck batches{ size_t(cmn::numberOf<KitchenerStatus>()) };
+    PositionCheck idle{ size_t(cmn::numberOf<KitchenerType>()) };
+    std::array<size_t, cmn::numberOf<KitchenerType>()> numOfType{};
+    for (size_t i = 0; i < numKitcheners; ++i) {
+        const KitchenerRecord kitchener{ reader.get<KitchenerRecord>(KITCHENERS, i) };
+        if (cmn::isValidEnum(kitchener.type_) == false || cmn::isValidEnum(kitchener.status_) == false
+            || (kitchener.food_ != none && isFood(kitchener.food_) == false))
+        {
+            return false;
+        }
+        batches.count(cmn::toUnderlying(kitchener.status_));
+        if (kitchener.idle_ != none) {
+            idle.count(cmn::toUnderlying(kitchener.type_));
+        }
+        ++numOfType[cmn::toUnderlying(kitchener.type_)];
+    }
+    for (size_t i = 0; i < numKitcheners; ++i) {
+        const KitchenerRecord kitchener{ reader.get<KitchenerRecord>(KITCHENERS, i) };
+        if (batches.take(cmn::toUnderlying(kitchener.status_), kitchener.batch_) == false
+            || (kitchener.idle_ != none && idle.take(cmn::toUnderlying(kitchener.type_), kitchener.idle_) == false))
+        {
+            return false;
+        }
+    }
+    for (size_t t = 0; t < cmn::numberOf<KitchenerType>(); ++t) {
+        // the kitchen plans the free time of every kitchener
+        if (reader.getSize(Section(FREE_TIMES + t)) != numOfType[t]
+            || areRefs(Section(KITCHEN_QUEUES + t), isFood) == false)
+        {
+            return false;
+        }
+    }
+
+    const size_t numCouriers{ reader.getSize(COURIERS) };
+    PositionCheck courierBatches{ size_t(cmn::numberOf<CourierStatus>()) };
+    size_t routeOrder{ 0 };
+    size_t routeEdge{ 0 };
+    for (size_t i = 0; i < numCouriers; ++i) {
+        const CourierRecord courier{ reader.get<CourierRecord>(COURIERS, i) };
+        if (cmn::isValidEnum(courier.status_) == false
+            || courier.routeOrders_ > reader.getSize(ROUTE_ORDERS) - routeOrder
+            || courier.routeEdges_ > reader.getSize(ROUTE_EDGES) - routeEdge
+            || (courier.hasRoute_ == 0 && (courier.routeOrders_ > 0 || courier.routeEdges_ > 0))
+            || (courier.curOrder_ != none && courier.curOrder_ >= courier.routeOrders_)
+            || (courier.curEdge_ != none && courier.curEdge_ >= courier.routeEdges_)
+            || (hasCurrentOrder(courier.prevStatus_) && courier.curOrder_ == none && courier.routeOrders_ > 0)
+            || (hasCurrentEdge(courier.prevStatus_) && courier.curEdge_ == none))
+        {
+            return false;
+        }
+        courierBatches.count(cmn::toUnderlying(courier.status_));
+        // each order of the route is a stop on its path as the route finds the stops
+        size_t stop{ 0 };
+        for (unsigned long long int e = 0; e < courier.routeEdges_; ++e) {
+            const EdgeReference edge{ reader.get<EdgeReference>(ROUTE_EDGES, routeEdge + size_t(e)) };
+            if (edge.source_ >= numVertices
+                || edge.index_ >= firstEdge[size_t(edge.source_) + 1] - firstEdge[size_t(edge.source_)])
+            {
+                return false;
+            }
+        }
+        auto getTarget{ [&](size_t e) {
+            const EdgeReference edge{ reader.get<EdgeReference>(ROUTE_EDGES, routeEdge + e) };
+            return reader.get<EdgeRecord>(EDGES, firstEdge[size_t(edge.source_)] + size_t(edge.index_)).target_;
+        } };
+        for (unsigned long long int o = 0; o < courier.routeOrders_; ++o) {
+            const unsigned long long int ref{ reader.get<unsigned long long int>(ROUTE_ORDERS, routeOrder + size_t(o)) };
+            if (isOrder(ref) == false) {
+                return false;
+            }
+            const unsigned long long int target{ reader.get<OrderRecord>(ORDERS, size_t(ref)).target_ };
+            if (o > 0 && stop < courier.routeEdges_ && getTarget(stop) != target) {
+                ++stop;
+            }
+            while (stop < courier.routeEdges_ && getTarget(stop) != target) {
+                ++stop;
+            }
+            if (stop == courier.routeEdges_) {
+                return false;
+            }
+        }
+        routeOrder += size_t(courier.routeOrders_);
+        routeEdge += size_t(courier.routeEdges_);
+    }
+    for (size_t i = 0; i < numCouriers; ++i) {
+        const CourierRecord courier{ reader.get<CourierRecord>(COURIERS, i) };
+        if (courierBatches.take(cmn::toUnderlying(courier.status_), courier.batch_) == false) {
+            return false;
+        }
+    }
+    return routeOrder == reader.getSize(ROUTE_ORDERS)
+        && routeEdge == reader.getSize(ROUTE_EDGES)
+        && reader.getSize(DELIVERY_TARGETS) == reader.getSize(DELIVERY_QUEUE)
+        && areRefs(KITCHEN_ORDERS, isOrder)
+        && areRefs(DELIVERY_ORDERS, isOrder)
+        && areRefs(DELIVERY_QUEUE, isOrder)
+        && areRefs(COMPLETED_ORDERS, isOrder)
+        && reader.getSize(RANDOM_STATE) == 1
+        && reader.get<unsigned long long int>(RANDOM_STATE, 0) <= numeric_limits<unsigned int>::max();
+}
+
+} // namespace
+
+///************************************************************************************************
+
+bool Checkpoint::write(const ManagmentSystem& ms, const string& fileName)
+{
+    const Kitchen& kitchen{ ms.kitchen_ };
+    const Delivery& delivery{ ms.delivery_ };
+    // the orders and the workers are passed only within an update
+    assert(kitchen.completed_.empty() && kitchen.changed_.empty() && delivery.changed_.empty());
+
+    SectionWriter writer{};
+    const Graph& graph{ ms.map_.graph() };
+    for (size_t v = 0; v < graph.m_vertices.size(); ++v) {
+        const GraphVertexPropertyMap& vertex{ graph[v] };
+        writer.add(VERTICES, VertexRecord{ vertex.num_, vertex.x_, vertex.y_ });
+    }
+    for (size_t v = 0; v < graph.m_vertices.size(); ++v) {
+        for (auto [iter, end]{ boost::out_edges(v, graph) }; iter != end; ++iter) {
+            const GraphEdgePropertyMap& edge{ graph[*iter] };
+            writer.add(EDGES, EdgeRecord{ v, iter->m_target, edge.num_, edge.distance_, edge.time_, 0 });
+        }
+    }
+
+    unordered_map<const Order*, unsigned long long int> orderIndex{};
+    orderIndex.reserve(ms.orders_.size());
+    const OrderTable& table{ ms.orderTable_ };
+    for (const auto& order : ms.orders_) {
+        orderIndex.emplace(order.get(), orderIndex.size());
+        const size_t h{ table.index(order->getHandle()) };
+        OrderRecord record{};
+        record.id_ = table.id_[h];
+        record.target_ = table.target_[h];
+        record.timeStart_ = table.timeStart_[h];
+        record.timeEnd_ = table.timeEnd_[h];
+        record.readyTime_ = table.readyTime_[h];
+        record.phaseStart_ = table.phaseStart_[h];
+        record.status_ = table.status_[h];
+        record.isPaid_ = table.isPaid_[h];
+        record.numFood_ = static_cast<unsigned char>(order->getFood().size());
+        for (size_t f = 0; f < order->getFood().size(); ++f) {
+            const Food& food{ order->getFood()[f] };
+            record.food_[f] = FoodRecord{ food.qty_, food.name_, food.status_ };
+        }
+        writer.add(ORDERS, record);
+    }
+    auto getOrderRef{ [&orderIndex](const Order* order) {
+        assert(orderIndex.count(order) == 1);
+        return orderIndex.at(order);
+    } };
+    auto getFoodRef{ [&ms, &getOrderRef](const Food* food) {
+        if (food == nullptr) {
+            return none;
+        }
+        const Order* order{ &ms.getOrder(food->getOrderHandle()) };
+        return getOrderRef(order) * Order::maxFood_ + static_cast<unsigned long long int>(food - order->getFood().begin());
+    } };
+    auto getPosition{ [](const auto& list, const auto* worker) {
+        const auto iter{ find(list.cbegin(), list.cend(), worker) };
+        return iter == list.cend() ? none : static_cast<unsigned long long int>(iter - list.cbegin());
+    } };
+
+    for (const auto& kitchener : ms.kitcheners_) {
+        KitchenerRecord record{};
+        record.food_ = getFoodRef(kitchener->food_);
+        record.batch_ = getPosition(kitchen.batches_[cmn::toUnderlying(kitchener->status_)], kitchener.get());
+        record.idle_ = getPosition(kitchen.idle_[cmn::toUnderlying(kitchener->type_)], kitchener.get());
+        record.passedTime_ = kitchener->passedTime_.count();
+        record.makingTime_ = kitchener->makingTime_.count();
+        record.id_ = kitchener->id_;
+        record.type_ = kitchener->type_;
+        record.status_ = kitchener->status_;
+        record.prevStatus_ = kitchener->prevStatus_;
+        assert(record.batch_ != none);
+        writer.add(KITCHENERS, record);
+    }
+    for (const Order* order : kitchen.orders_) {
+        writer.add(KITCHEN_ORDERS, getOrderRef(order));
+    }
+    const vector<Food*>* queues[]{ &kitchen.queueDough_, &kitchen.queueFilling_, &kitchen.queuePicker_ };
+    static_assert(cmn::numberOf<KitchenerType>() == 3);
+    for (size_t t = 0; t < cmn::numberOf<KitchenerType>(); ++t) {
+        for (const Food* food : *queues[t]) {
+            writer.add(Section(KITCHEN_QUEUES + t), getFoodRef(food));
+        }
+        for (const cmn::tick_t freeTime : kitchen.freeTime_[t]) {
+            writer.add(Section(FREE_TIMES + t), freeTime);
+        }
+    }
+
+    for (const auto& courier : ms.couriers_) {
+        const Route* route{ courier->route_.get() };
+        CourierRecord record{};
+        record.batch_ = getPosition(delivery.batches_[cmn::toUnderlying(courier->status_)], courier.get());
+        record.routeOrders_ = route == nullptr ? 0 : route->getOrders().size();
+        record.routeEdges_ = route == nullptr ? 0 : route->getPath().size();
+        record.curOrder_ = route != nullptr && hasCurrentOrder(courier->prevStatus_) ?
+            static_cast<unsigned long long int>(courier->curOrder_ - courier->route_->getOrders().begin()) : none;
+        record.curEdge_ = route != nullptr && hasCurrentEdge(courier->prevStatus_) ?
+            static_cast<unsigned long long int>(courier->curEdge_ - route->getPath().cbegin()) : none;
+        record.passedTime_ = courier->passedTime_.count();
+        record.makingTime_ = courier->makingTime_.count();
+        record.passedDist_ = courier->passedDist_;
+        record.fullDist_ = courier->fullDist_;
+        record.x_ = courier->curLocation_.x;
+        record.y_ = courier->curLocation_.y;
+        record.id_ = courier->id_;
+        record.status_ = courier->status_;
+        record.prevStatus_ = courier->prevStatus_;
+        record.hasRoute_ = route == nullptr ? 0 : 1;
+        assert(record.batch_ != none);
+        writer.add(COURIERS, record);
+        if (route != nullptr) {
+            for (const Order* order : route->getOrders()) {
+                writer.add(ROUTE_ORDERS, getOrderRef(order));
+            }
+            for (const auto& edge : route->getPath()) {
+                writer.add(ROUTE_EDGES, getEdgeReference(graph, edge));
+            }
+        }
+    }
+    for (const Order* order : delivery.orders_) {
+        writer.add(DELIVERY_ORDERS, getOrderRef(order));
+    }
+    for (const Order* order : delivery.queue_) {
+        writer.add(DELIVERY_QUEUE, getOrderRef(order));
+    }
+    for (const MapTarget& target : delivery.targets_) {
+        writer.add(DELIVERY_TARGETS, target);
+    }
+    for (const Order* order : ms.scheduler_.orders_) {
+        writer.add(COMPLETED_ORDERS, getOrderRef(order));
+    }
+    // the saved system and the restored one go on from the same new seed
+    const unsigned int seed{ cmn::reseedRandomNumbers() };
+    if (ms.eventLog_ != nullptr) {
+        ms.eventLog_->addSeed(seed);
+    }
+    writer.add(RANDOM_STATE, static_cast<unsigned long long int>(seed));
+
+    Header header{};
+    copy(begin(checkpointMagic), end(checkpointMagic), header.magic_);
+    header.version_ = version_;
+    header.tick_ = ms.currentTick_;
+    header.startTime_ = chrono::duration_cast<chrono::nanoseconds>(ms.startTime_.time_since_epoch()).count();
+    header.nextOrderID_ = cmn::toUnderlying(ms.nextOrderID_);
+    header.orderIDStep_ = ms.orderIDStep_;
+    header.office_ = ms.scheduler_.getOffice();
+    header.checkTime_ = delivery.checkTime_.count();
+    header.routedOrders_ = delivery.routedOrders_;
+    header.options_ = takeOptions(ms.options());
+    return writer.write(header, fileName);
+}
+
+bool Checkpoint::restore(ManagmentSystem& ms, const string& fileName)
+{
+    // a recording can not start from a restored state
+    assert(ms.orders_.empty() && ms.couriers_.empty() && ms.kitcheners_.empty() && ms.eventLog_ == nullptr);
+    ifstream file{ fileName, ios::binary | ios::ate };
+    if (file.is_open() == false) {
+        return false;
+    }
+    const streamoff size{ file.tellg() };
+    if (size < streamoff(sizeof(Header))) {
+        return false;
+    }
+    // the whole file is read at once, the records are taken from the memory
+    vector<unsigned char> data(static_cast<size_t>(size));
+    file.seekg(0);
+    if (file.read(reinterpret_cast<char*>(data.data()), size).fail()) {
+        return false;
+    }
+    Header header{};
+    memcpy(&header, data.data(), sizeof(Header));
+    SectionReader reader{ data };
+    if (equal(begin(checkpointMagic), end(checkpointMagic), header.magic_) == false
+        || header.version_ != version_
+        || header.office_ != ms.scheduler_.getOffice()
+        || reader.open(header) == false
+        || isValid(reader, header) == false)
+    {
+        return false;
+    }
+
+    // nothing fails from here on
+    cmn::seedRandomNumbers(static_cast<unsigned int>(reader.get<unsigned long long int>(RANDOM_STATE, 0)));
+    applyOptions(header.options_, ms.options_);
+    // the options set before the restore are dropped, otherwise the next update would replace the restored ones
+    ms.nextOptions_.update();
+    Graph graph{};
+    for (size_t i = 0; i < reader.getSize(VERTICES); ++i) {
+        const VertexRecord vertex{ reader.get<VertexRecord>(VERTICES, i) };
+        boost::add_vertex(GraphVertexPropertyMap{ vertex.num_, vertex.x_, vertex.y_ }, graph);
+    }
+    for (size_t i = 0; i < reader.getSize(EDGES); ++i) {
+        const EdgeRecord edge{ reader.get<EdgeRecord>(EDGES, i) };
+        boost::add_edge(size_t(edge.source_), size_t(edge.target_),
+            GraphEdgePropertyMap{ edge.num_, edge.distance_, edge.time_ }, graph);
+    }
+    ms.map_.setGraph(std::move(graph));
+    ms.currentTick_ = header.tick_;
+    ms.startTime_ = ManagmentSystem::time_point_t{
+        chrono::duration_cast<ManagmentSystem::time_point_t::duration>(chrono::nanoseconds{ header.startTime_ })
+    };
+    ms.nextOrderID_ = OrderID{ header.nextOrderID_ };
+    ms.orderIDStep_ = static_cast<unsigned int>(header.orderIDStep_);
+
+    OrderTable& table{ ms.orderTable_ };
+    table.setCurrentTick(header.tick_);
+    ms.orders_.reserve(reader.getSize(ORDERS));
+    for (size_t i = 0; i < reader.getSize(ORDERS); ++i) {
+        const OrderRecord record{ reader.get<OrderRecord>(ORDERS, i) };
+        const OrderHandle handle{ table.addOrder(record.id_, size_t(record.target_), record.timeStart_) };
+        const size_t h{ table.index(handle) };
+        table.timeEnd_[h] = record.timeEnd_;
+        table.readyTime_[h] = record.readyTime_;
+        table.status_[h] = record.status_;
+        ++table.statusCount_[cmn::toUnderlying(record.status_)];
+        table.isPaid_[h] = record.isPaid_;
+        table.phaseStart_[h] = record.phaseStart_;
+        unique_ptr<Order> order{ new Order{ table, handle } };
+        Order::food_list_t food{};
+        for (size_t f = 0; f < record.numFood_; ++f) {
+            food.push_back(Food{ record.food_[f].qty_, record.food_[f].name_ });
+        }
+        order->setFood(food);
+        // the statuses are set without the transitions, so nothing is traced
+        order->foodCount_.fill(0);
+        for (size_t f = 0; f < record.numFood_; ++f) {
+            order->food_[f].status_ = record.food_[f].status_;
+            ++order->foodCount_[cmn::toUnderlying(record.food_[f].status_)];
+        }
+        ms.orders_.push_back(std::move(order));
+    }
+    auto getOrder{ [&ms, &reader](Section section, size_t index) {
+        return ms.orders_[size_t(reader.get<unsigned long long int>(section, index))].get();
+    } };
+    auto getFood{ [&ms](unsigned long long int ref) -> Food* {
+        if (ref == none) {
+            return nullptr;
+        }
+        return &ms.orders_[size_t(ref / Order::maxFood_)]->food_[size_t(ref % Order::maxFood_)];
+    } };
+
+    Kitchen& kitchen{ ms.kitchen_ };
+    const size_t numKitcheners{ reader.getSize(KITCHENERS) };
+    ms.kitcheners_.reserve(numKitcheners);
+    for (size_t i = 0; i < numKitcheners; ++i) {
+        const KitchenerRecord record{ reader.get<KitchenerRecord>(KITCHENERS, i) };
+        auto& batch{ kitchen.batches_[cmn::toUnderlying(record.status_)] };
+        batch.resize(std::max(batch.size(), size_t(record.batch_) + 1));
+        if (record.idle_ != none) {
+            auto& idle{ kitchen.idle_[cmn::toUnderlying(record.type_)] };
+            idle.resize(std::max(idle.size(), size_t(record.idle_) + 1));
+        }
+    }
+    for (size_t i = 0; i < numKitcheners; ++i) {
+        const KitchenerRecord record{ reader.get<KitchenerRecord>(KITCHENERS, i) };
+        unique_ptr<Kitchener> kitchener{ new Kitchener{ ms, record.id_, record.type_ } };
+        kitchener->food_ = getFood(record.food_);
+        kitchener->passedTime_ = chrono::nanoseconds{ record.passedTime_ };
+        kitchener->makingTime_ = chrono::nanoseconds{ record.makingTime_ };
+        kitchener->status_ = record.status_;
+        kitchener->prevStatus_ = record.prevStatus_;
+        kitchen.batches_[cmn::toUnderlying(record.status_)][size_t(record.batch_)] = kitchener.get();
+        if (record.idle_ != none) {
+            kitchen.idle_[cmn::toUnderlying(record.type_)][size_t(record.idle_)] = kitchener.get();
+        }
+        ms.kitcheners_.push_back(std::move(kitchener));
+    }
+    for (size_t i = 0; i < reader.getSize(KITCHEN_ORDERS); ++i) {
+        kitchen.orders_.push_back(getOrder(KITCHEN_ORDERS, i));
+    }
+    size_t numFood{ 0 };
+    for (const Order* order : kitchen.orders_) {
+        numFood += order->getFood().size();
+    }
+    for (size_t t = 0; t < cmn::numberOf<KitchenerType>(); ++t) {
+        vector<Food*>& queue{ kitchen.getQueue(static_cast<KitchenerType>(t)) };
+        queue.reserve(numFood);
+        for (size_t i = 0; i < reader.getSize(Section(KITCHEN_QUEUES + t)); ++i) {
+            queue.push_back(getFood(reader.get<unsigned long long int>(Section(KITCHEN_QUEUES + t), i)));
+        }
+        for (size_t i = 0; i < reader.getSize(Section(FREE_TIMES + t)); ++i) {
+            kitchen.freeTime_[t].push_back(reader.get<cmn::tick_t>(Section(FREE_TIMES + t), i));
+        }
+        kitchen.idle_[t].reserve(kitchen.freeTime_[t].size());
+    }
+    // the containers are reserved as by adding the kitcheners and the orders one by one
+    for (auto& batch : kitchen.batches_) {
+        batch.reserve(numKitcheners);
+    }
+    kitchen.changed_.reserve(numKitcheners);
+    kitchen.plan_.reserve(numFood);
+    for (auto& arrivals : kitchen.arrivals_) {
+        arrivals.reserve(numFood);
+    }
+    // the food planned to come to the stations is not saved, so all of them are planned at the next update
+    kitchen.invalidatePlan(cmn::firstEnum<KitchenerType>());
+    kitchen.completed_.reserve(kitchen.orders_.size());
+
+    Delivery& delivery{ ms.delivery_ };
+    const size_t numCouriers{ reader.getSize(COURIERS) };
+    ms.couriers_.reserve(numCouriers);
+    for (size_t i = 0; i < numCouriers; ++i) {
+        const CourierRecord record{ reader.get<CourierRecord>(COURIERS, i) };
+        auto& batch{ delivery.batches_[cmn::toUnderlying(record.status_)] };
+        batch.resize(std::max(batch.size(), size_t(record.batch_) + 1));
+    }
+    size_t routeOrder{ 0 };
+    size_t routeEdge{ 0 };
+    for (size_t i = 0; i < numCouriers; ++i) {
+        const CourierRecord record{ reader.get<CourierRecord>(COURIERS, i) };
+        unique_ptr<Courier> courier{ new Courier{ ms, record.id_ } };
+        if (record.hasRoute_ != 0) {
+            vector<Order*> orders{};
+            orders.reserve(size_t(record.routeOrders_));
+            for (unsigned long long int o = 0; o < record.routeOrders_; ++o) {
+                orders.push_back(getOrder(ROUTE_ORDERS, routeOrder++));
+            }
+            vector<Graph::edge_descriptor> path{};
+            path.reserve(size_t(record.routeEdges_));
+            for (unsigned long long int e = 0; e < record.routeEdges_; ++e) {
+                const EdgeReference edge{ reader.get<EdgeReference>(ROUTE_EDGES, routeEdge++) };
+                auto iter{ boost::out_edges(size_t(edge.source_), ms.map_.graph()).first };
+                advance(iter, edge.index_);
+                path.push_back(*iter);
+            }
+            unique_ptr<Route> route{ new Route{ ms.map_, std::move(orders), std::move(path) } };
+            courier->setRoute(route);
+            if (record.curOrder_ != none) {
+                courier->curOrder_ = courier->route_->getOrders().begin() + ptrdiff_t(record.curOrder_);
+            }
+            if (record.curEdge_ != none) {
+                courier->curEdge_ = courier->route_->getPath().cbegin() + ptrdiff_t(record.curEdge_);
+            }
+        }
+        courier->passedTime_ = chrono::nanoseconds{ record.passedTime_ };
+        courier->makingTime_ = chrono::nanoseconds{ record.makingTime_ };
+        courier->passedDist_ = record.passedDist_;
+        courier->fullDist_ = record.fullDist_;
+        courier->curLocation_ = ImVec2{ record.x_, record.y_ };
+        courier->status_ = record.status_;
+        courier->prevStatus_ = record.prevStatus_;
+        delivery.batches_[cmn::toUnderlying(record.status_)][size_t(record.batch_)] = courier.get();
+        ms.couriers_.push_back(std::move(courier));
+    }
+    for (auto& batch : delivery.batches_) {
+        batch.reserve(numCouriers);
+    }
+    delivery.changed_.reserve(numCouriers);
+    for (size_t i = 0; i < reader.getSize(DELIVERY_ORDERS); ++i) {
+        delivery.orders_.push_back(getOrder(DELIVERY_ORDERS, i));
+    }
+    for (size_t i = 0; i < reader.getSize(DELIVERY_QUEUE); ++i) {
+        delivery.queue_.push_back(getOrder(DELIVERY_QUEUE, i));
+        delivery.targets_.push_back(reader.get<MapTarget>(DELIVERY_TARGETS, i));
+    }
+    delivery.reserveOrders(kitchen.getNumberOfOrders());
+    // the deadlines follow the restored options even if they were changed just before the checkpoint
+    delivery.deliveryTime_ = ms.options_.optDelivery_.deliveryTime_;
+    for (size_t i = 0; i < delivery.queue_.size(); ++i) {
+        delivery.targets_[i].deadline_ =
+            delivery.queue_[i]->getTimeStart() / cmn::ticksPerSecond + delivery.deliveryTime_;
+    }
+    delivery.checkTime_ = chrono::nanoseconds{ header.checkTime_ };
+    delivery.routedOrders_ = header.routedOrders_;
+
+    for (size_t i = 0; i < reader.getSize(COMPLETED_ORDERS); ++i) {
+        ms.scheduler_.orders_.push_back(getOrder(COMPLETED_ORDERS, i));
+    }
+    return true;
+}
+
+} // namespace ds
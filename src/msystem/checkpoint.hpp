@@ -0,0 +1,41 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include"msystem.hpp"
+#include<string>
+
+namespace ds {
+
+// Snapshot of the whole state of a managment system in a flat binary file: the clock, the orders
+// with their food, the kitchen queues and plans, the kitcheners, the couriers with their routes
+// and positions, the delivery queue, the options, the map and the random numbers of the thread.
+// The file is a header with the number of records in each section followed by the sections
+// of fixed-width records, the pointers are stored as indices, so a restore is a single read
+// and a pass over the records. A system restored from a checkpoint goes on exactly as the saved one.
+// The latency histograms of the scheduler are not saved, they start empty at the restore.
+class Checkpoint {
+public:
+    static constexpr unsigned long long int version_{ 3 };
+
+public:
+    Checkpoint() = delete;
+
+public:
+    // must be called between the updates, the random numbers of the thread go on from a new seed then;
+    // returns false if the file can not be written
+    static bool write(const ManagmentSystem& ms, const std::string& fileName);
+
+    // must be called from the thread of the updates, the system must have no orders and no workers,
+    // its office must be the saved one;
+    // returns false if the file can not be read or is not a valid checkpoint, the system is not changed then
+    static bool restore(ManagmentSystem& ms, const std::string& fileName);
+};
+
+} // namespace ds
+
+#endif // !CHECKPOINT_HPP
@@ -8,8 +8,11 @@
 #include"delivery.hpp"
 #include"msystem.hpp"
 #include"options.hpp"
+#include"trace.hpp"
 #include<algorithm>
 #include<assert.h>
+#include<functional>
+#include<limits>
 
 namespace ds {
 
@@ -20,78 +23,212 @@ Delivery::Delivery()
     ms_             { nullptr },
     orders_         {},
     queue_          {},
-    couriers_       {}
+    targets_        {},
+    batches_        {},
+    changed_        {},
+    arrival_        {},
+    routeOrders_    {},
+    routes_         {},
+    emptyPath_      {},
+    checkTime_      { 0 },
+    deliveryTime_   { OptionsDelivery::defDeliveryTime_ },
+    routedOrders_   { 0 }
 {}
 
 void Delivery::update(chrono::nanoseconds passedTime)
 {
-    const chrono::seconds checkTime{ Options::instance().optDelivery_.checkTimeFreeCour_ };
-    static chrono::nanoseconds time{ 0 };
-    time += passedTime;
-    if (time >= checkTime) {
-        time -= checkTime;
+    const cmn::TraceSpan span{ u8"Delivery::update" };
+    const chrono::seconds checkTime{ ms_->options().optDelivery_.checkTimeFreeCour_ };
+    checkTime_ += passedTime;
+    if (checkTime_ >= checkTime) {
+        checkTime_ -= checkTime;
         this->distributeOrders();
     }
-    for (auto& c : couriers_) {
-        c->update(passedTime);
-    }
+    this->updateCouriers(passedTime);
     this->processOrders();
 }
 
+void Delivery::updateCouriers(chrono::nanoseconds passedTime)
+{
+    this->updateBatch<&Courier::updateInaccessible>(CourierStatus::INACCESSIBLE, passedTime);
+    this->updateBatch<&Courier::updateWaiting>(CourierStatus::WAITING_FOR_NEXT, passedTime);
+    this->updateBatch<&Courier::updateAccepting>(CourierStatus::ACCEPTING_ORDER, passedTime);
+    this->updateBatch<&Courier::updateMovement>(CourierStatus::MOVEMENT_TO_CUSTOMER, passedTime);
+    this->updateBatch<&Courier::updateDeliveryPayment>(CourierStatus::DELIVERY_AND_PAYMENT, passedTime);
+    this->updateBatch<&Courier::updateReturning>(CourierStatus::RETURNING_TO_OFFICE, passedTime);
+    static_assert(cmn::numberOf<CourierStatus>() == 6);
+    // the time left after changing the status is spent in the next status,
+    // then the couriers join the batches of their new statuses
+    for (Courier* courier : changed_) {
+        courier->update(chrono::nanoseconds{ 0 });
+        batches_[cmn::toUnderlying(courier->getStatus())].push_back(courier);
+    }
+    changed_.clear();
+}
+
+template <void (*Update)(Courier&, chrono::nanoseconds)>
+void Delivery::updateBatch(CourierStatus status, chrono::nanoseconds passedTime)
+{
+    vector<Courier*>& batch{ batches_[cmn::toUnderlying(status)] };
+    for (size_t i = 0; i < batch.size();) {
+        Courier* courier{ batch[i] };
+        Update(*courier, passedTime);
+        if (courier->prevStatus_ != courier->status_) {
+            changed_.push_back(courier);
+            batch[i] = batch.back();
+            batch.pop_back();
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
 void Delivery::distributeOrders()
 {
-    vector<Courier*> delivering;
-    for (auto iterCourier{ couriers_.begin() }; iterCourier != couriers_.end();) {
+    const cmn::TraceSpan span{ u8"Delivery::distributeOrders" };
+    this->updateDeadlines();
+    for (Courier* courier : batches_[cmn::toUnderlying(CourierStatus::WAITING_FOR_NEXT)]) {
         if (queue_.empty() == true) {
             break;
         }
-        bool advance{ true };
-        Courier* courier{ *iterCourier };
-        if (courier->getStatus() == CourierStatus::WAITING_FOR_NEXT) {
-            vector<Graph::vertex_descriptor> tgtVertices{
-                vector<Graph::vertex_descriptor>(queue_.size(), Graph::vertex_descriptor{ 0 })
-            };
-            vector<chrono::seconds> remainingTime{
-                vector<chrono::seconds>(queue_.size(), chrono::seconds{ 0 })
-            };
-            const auto currentTime{ ms_->getCurrentTime() };
-            assert(queue_.size() == tgtVertices.size());
-            assert(queue_.size() == remainingTime.size());
-            for (int i = 0; i < queue_.size(); ++i) {
-                Order* order{ queue_[i] };
-                assert(order->getStatus() == OrderStatus::WAITING_FOR_DELIVERY);
-                tgtVertices[i] = order->getTarget();
-                remainingTime[i] = chrono::seconds{
-                    Options::instance().optDelivery_.deliveryTime_ -
-                    chrono::duration_cast<chrono::seconds>(
-                        currentTime - order->getTimeStart()).count()
-                };
+        if (courier->getRoute() != nullptr) {
+            continue;
+        }
+        const long long int currentTime{ ms_->getCurrentTick() / cmn::ticksPerSecond };
+        // the search of the route allocates its labels and its result, the route itself is reused
+        MapPath mp{ ms_->map().getPath(ms_->scheduler().getOffice(), targets_, currentTime, ms_->options()) };
+        routeOrders_.clear();
+        for (auto i : mp.visited_) {
+            routeOrders_.push_back(queue_[i]);
+        }
+        unique_ptr<Route> route{};
+        if (routes_.empty()) {
+            route.reset(new Route{ ms_->map(), routeOrders_, std::move(mp.path_) });
+        }
+        else {
+            route = std::move(routes_.back());
+            routes_.pop_back();
+            route->setPath(routeOrders_, mp.path_);
+        }
+        courier->setRoute(route);
+        // the routed orders are removed from the back, so the heap is restored only once
+        sort(mp.visited_.begin(), mp.visited_.end(), greater<size_t>{});
+        for (auto i : mp.visited_) {
+            this->eraseQueue(i);
+        }
+        routedOrders_ += mp.visited_.size();
+        this->makeQueue();
+    }
+    if (ms_->options().optDelivery_.lateInsertion_ && queue_.empty() == false) {
+        // the most urgent orders take the detours first; the sorted queue stays a heap
+        // when the inserted orders are removed from it
+        this->sortQueue();
+        size_t numKept{ 0 };
+        for (size_t i = 0; i < queue_.size(); ++i) {
+            if (this->insertOrder(queue_[i])) {
+                ++routedOrders_;
+                continue;
             }
-            MapPath mp{
-                ms_->map().getPath(ms_->scheduler().getOffice(), tgtVertices, remainingTime)
+            queue_[numKept] = queue_[i];
+            targets_[numKept] = targets_[i];
+            ++numKept;
+        }
+        queue_.resize(numKept);
+        targets_.resize(numKept);
+    }
+}
+
+bool Delivery::insertOrder(Order* order)
+{
+    assert(order != nullptr);
+    assert(order->getStatus() == OrderStatus::WAITING_FOR_DELIVERY);
+    const auto& graph{ ms_->map().graph() };
+    const OptionsSimulation& options{ ms_->options() };
+    const cmn::tick_t currentTime{ ms_->getCurrentTick() };
+    const int serviceTime{ options.optCourier_.deliveryTime_ + options.optCourier_.paymentTime_ };
+    auto getRemainingTime{ [&](const Order* o) {
+        return options.optDelivery_.deliveryTime_ -
+            int((currentTime - o->getTimeStart()) / cmn::ticksPerSecond);
+    } };
+    auto getPathTime{ [&](const vector<Graph::edge_descriptor>& path) {
+        int time{ 0 };
+        for (const auto& edge : path) {
+            time += graph[edge].time_;
+        }
+        return time;
+    } };
+    Courier* bestCourier{ nullptr };
+    size_t bestPosition{ 0 };
+    int bestCost{ numeric_limits<int>::max() };
+    const vector<Graph::edge_descriptor>* bestPathTo{ nullptr };
+    const vector<Graph::edge_descriptor>* bestPathFrom{ nullptr };
+    vector<int>& arrival{ arrival_ };
+    for (Courier* courier : batches_[cmn::toUnderlying(CourierStatus::ACCEPTING_ORDER)]) {
+        const Route& route{ *courier->getRoute() };
+        const auto& orders{ route.getOrders() };
+        const auto& path{ route.getPath() };
+        const auto& stops{ route.getStops() };
+        // expected arrival time at each stop of the route, seconds from now
+        const int departure{
+            int(cmn::toTicks(courier->getTimeToDeparture()) / cmn::ticksPerSecond) };
+        int time{ departure };
+        arrival.clear();
+        for (size_t i = 0, j = 0; i < orders.size(); ++i) {
+            for (; j <= stops[i]; ++j) {
+                time += graph[path[j]].time_;
+            }
+            arrival.push_back(time);
+            time += serviceTime;
+        }
+        // try every position, only the detour through the new target is evaluated
+        for (size_t pos = 0; pos <= orders.size(); ++pos) {
+            const size_t prevVertex{
+                pos == 0 ? ms_->scheduler().getOffice() : orders[pos - 1]->getTarget()
             };
-            vector<Order*> orders;
-            for (auto i : mp.visited_) {
-                orders.push_back(queue_[i]);
+            const int prevDeparture{ pos == 0 ? departure : arrival[pos - 1] + serviceTime };
+            const auto pathTo{ ms_->paths().findPath(prevVertex, order->getTarget(), options) };
+            if (pathTo == nullptr) {
+                continue;
             }
-            unique_ptr<Route> route{ new Route{ *ms_, std::move(orders), std::move(mp.path_) } };
-            courier->setRoute(route);
-            iterCourier = couriers_.erase(iterCourier);
-            delivering.push_back(courier);
-            auto newEnd{ queue_.end() };
-            for (auto iterOrder{ courier->getRoute()->getOrders().cbegin() };
-                iterOrder != courier->getRoute()->getOrders().cend(); ++iterOrder)
-            {
-                newEnd = remove(queue_.begin(), newEnd, *iterOrder);
+            const int timeTo{ getPathTime(*pathTo) };
+            if (prevDeparture + timeTo > getRemainingTime(order)) {
+                continue;
+            }
+            int cost{ timeTo + serviceTime };
+            const vector<Graph::edge_descriptor>* pathFrom{ &emptyPath_ };
+            if (pos < orders.size()) {
+                pathFrom = ms_->paths().findPath(order->getTarget(), orders[pos]->getTarget(), options);
+                if (pathFrom == nullptr) {
+                    continue;
+                }
+                // delay of the orders following the inserted one
+                cost += getPathTime(*pathFrom) - (arrival[pos] - prevDeparture);
+                bool isFeasible{ true };
+                for (size_t i = pos; cost > 0 && i < orders.size(); ++i) {
+                    if (arrival[i] + cost > getRemainingTime(orders[i])) {
+                        isFeasible = false;
+                        break;
+                    }
+                }
+                if (isFeasible == false) {
+                    continue;
+                }
+            }
+            if (cost < bestCost) {
+                bestCourier = courier;
+                bestPosition = pos;
+                bestCost = cost;
+                bestPathTo = pathTo;
+                bestPathFrom = pathFrom;
             }
-            queue_.erase(newEnd, queue_.end());
-            advance = false;
-        }
-        if (advance) {
-            ++iterCourier;
         }
     }
-    couriers_.insert(couriers_.end(), delivering.begin(), delivering.end());
+    if (bestCourier == nullptr) {
+        return false;
+    }
+    bestCourier->insertOrder(bestPosition, order, *bestPathTo, *bestPathFrom);
+    return true;
 }
 
 void Delivery::processOrders()
@@ -113,25 +250,142 @@ void Delivery::processOrders()
 void Delivery::deliveryOrder(Order* order)
 {
     assert(order != nullptr);
-    order->setStatus(OrderStatus::WAITING_FOR_DELIVERY);
     orders_.push_back(order);
+    if (order->getTarget() == ms_->scheduler().getOffice()) {
+        // the order is taken at the office, a route never stops there
+        order->setStatus(OrderStatus::DELIVERING_COMPLETED);
+        return;
+    }
+    order->setStatus(OrderStatus::WAITING_FOR_DELIVERY);
+    this->pushQueue(order);
+}
+
+void Delivery::reserveOrders(size_t numOrders)
+{
+    cmn::reserveGrowing(orders_, orders_.size() + numOrders);
+    cmn::reserveGrowing(queue_, queue_.size() + numOrders);
+    cmn::reserveGrowing(targets_, targets_.size() + numOrders);
+    cmn::reserveGrowing(arrival_, orders_.size() + numOrders);
+    cmn::reserveGrowing(routeOrders_, orders_.size() + numOrders);
+}
+
+void Delivery::pushQueue(Order* order)
+{
+    this->updateDeadlines();
+    const long long int deadline{ order->getTimeStart() / cmn::ticksPerSecond + deliveryTime_ };
     queue_.push_back(order);
+    targets_.push_back(MapTarget{ order->getTarget(), deadline });
+    this->siftUp(queue_.size() - 1);
+}
+
+void Delivery::updateDeadlines()
+{
+    // the deadlines of all orders move by the same time, so the heap stays as it is
+    const int deliveryTime{ ms_->options().optDelivery_.deliveryTime_ };
+    if (deliveryTime == deliveryTime_) {
+        return;
+    }
+    for (MapTarget& target : targets_) {
+        target.deadline_ += deliveryTime - deliveryTime_;
+    }
+    deliveryTime_ = deliveryTime;
+}
+
+void Delivery::eraseQueue(size_t index)
+{
+    // the heap is not restored, 'makeQueue' must be called after erasing
+    assert(index < queue_.size());
+    this->swapQueue(index, queue_.size() - 1);
+    queue_.pop_back();
+    targets_.pop_back();
+}
+
+void Delivery::makeQueue()
+{
+    for (size_t i = queue_.size() / 2; i-- > 0;) {
+        this->siftDown(i, queue_.size());
+    }
+}
+
+void Delivery::sortQueue()
+{
+    // the root of the heap is moved behind the rest of the heap, then the order is reversed
+    for (size_t size = queue_.size(); size > 1; --size) {
+        this->swapQueue(0, size - 1);
+        this->siftDown(0, size - 1);
+    }
+    reverse(queue_.begin(), queue_.end());
+    reverse(targets_.begin(), targets_.end());
+}
+
+void Delivery::siftUp(size_t index)
+{
+    while (index > 0) {
+        const size_t parent{ (index - 1) / 2 };
+        if (targets_[parent].deadline_ <= targets_[index].deadline_) {
+            break;
+        }
+        this->swapQueue(parent, index);
+        index = parent;
+    }
+}
+
+void Delivery::siftDown(size_t index, size_t size)
+{
+    while (true) {
+        size_t first{ index };
+        const size_t left{ index * 2 + 1 };
+        const size_t right{ left + 1 };
+        if (left < size && targets_[left].deadline_ < targets_[first].deadline_) {
+            first = left;
+        }
+        if (right < size && targets_[right].deadline_ < targets_[first].deadline_) {
+            first = right;
+        }
+        if (first == index) {
+            break;
+        }
+        this->swapQueue(first, index);
+        index = first;
+    }
+}
+
+inline void Delivery::swapQueue(size_t index1, size_t index2)
+{
+    std::swap(queue_[index1], queue_[index2]);
+    std::swap(targets_[index1], targets_[index2]);
 }
 
 void Delivery::addCourier(Courier* courier)
 {
     assert(courier != nullptr);
-    couriers_.push_back(courier);
+    batches_[cmn::toUnderlying(courier->getStatus())].push_back(courier);
+    // any batch can hold all couriers, so the updates do not allocate
+    size_t numCouriers{ 0 };
+    for (const auto& batch : batches_) {
+        numCouriers += batch.size();
+    }
+    for (auto& batch : batches_) {
+        batch.reserve(numCouriers);
+    }
+    changed_.reserve(numCouriers);
+    routes_.reserve(numCouriers);
 }
 
 void Delivery::deleteCourier(Courier* courier)
 {
     assert(courier != nullptr);
-    for (auto iter{ couriers_.begin() }; iter != couriers_.end(); ++iter) {
-        if (*iter == courier) {
-            couriers_.erase(iter);
-            break;
-        }
+    auto& batch{ batches_[cmn::toUnderlying(courier->getStatus())] };
+    const auto iter{ find(batch.begin(), batch.end(), courier) };
+    if (iter != batch.end()) {
+        batch.erase(iter);
+    }
+}
+
+void Delivery::releaseRoute(unique_ptr<Route>& route)
+{
+    if (route != nullptr) {
+        routes_.push_back(std::move(route));
     }
 }
 
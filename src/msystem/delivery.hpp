@@ -7,17 +7,24 @@
 #ifndef DELIVERY_HPP
 #define DELIVERY_HPP
 
+#include"common.hpp"
 #include"courier.hpp"
+#include"map.hpp"
 #include"order.hpp"
+#include<array>
 #include<chrono>
 #include<utility>
 #include<vector>
 
 namespace ds {
 
+class Checkpoint;
 class ManagmentSystem;
 
 class Delivery {
+public:
+    friend Checkpoint;
+
 public:
     Delivery();
 
@@ -31,26 +38,77 @@ public:
 
     void deliveryOrder(Order* order);
 
+    // makes room for the orders that are yet to come from the kitchen
+    void reserveOrders(size_t numOrders);
+
     void addCourier(Courier* courier);
 
     void deleteCourier(Courier* courier);
 
+    // the route of a courier that is no longer needed, it is reused for the next dispatch
+    void releaseRoute(std::unique_ptr<Route>& route);
+
     void setManagmentSystem(ManagmentSystem* ms) { ms_ = ms; }
 
+    size_t getNumberOfCouriers(CourierStatus status) const
+    {
+        return batches_[cmn::toUnderlying(status)].size();
+    }
+
+    // number of orders given to the couriers since the start
+    unsigned long long int getNumberOfRoutedOrders() const noexcept { return routedOrders_; }
+
     auto getOrders() const { return std::pair{ orders_.cbegin(), orders_.cend() }; }
 
+    // the orders waiting for a courier in the order of the heap and their targets in the same order
+    auto getQueue() const { return std::pair{ queue_.cbegin(), queue_.cend() }; }
+
+    auto getQueueTargets() const { return std::pair{ targets_.cbegin(), targets_.cend() }; }
+
     //auto getOrders() { return std::pair{ orders_.begin(), orders_.end() }; }
 
 private:
     void distributeOrders();
 
+    void updateCouriers(std::chrono::nanoseconds passedTime);
+
+    template <void (*Update)(Courier&, std::chrono::nanoseconds)>
+    void updateBatch(CourierStatus status, std::chrono::nanoseconds passedTime);
+
     void processOrders();
 
+    bool insertOrder(Order* order);
+
+    void pushQueue(Order* order);
+
+    void updateDeadlines();
+
+    void eraseQueue(size_t index);
+
+    void makeQueue();
+
+    void sortQueue();
+
+    void siftUp(size_t index);
+
+    void siftDown(size_t index, size_t size);
+
+    void swapQueue(size_t index1, size_t index2);
+
 private:
     ManagmentSystem*                            ms_;
     std::vector<Order*>                         orders_;        // current orders in delivery
-    std::vector<Order*>                         queue_;         // order queue for couriers
-    std::vector<Courier*>                       couriers_;      // working couriers
+    std::vector<Order*>                         queue_;         // order queue for couriers, min-heap on the deadline
+    std::vector<MapTarget>                      targets_;       // targets of the orders in 'queue_', in the same order
+    std::array<std::vector<Courier*>, cmn::numberOf<CourierStatus>()> batches_; // working couriers of each status
+    std::vector<Courier*>                       changed_;       // couriers that changed the status during the update
+    std::vector<int>                            arrival_;       // buffer of 'insertOrder'
+    std::vector<Order*>                         routeOrders_;   // buffer of 'distributeOrders'
+    std::vector<std::unique_ptr<Route>>         routes_;        // released routes, their storage is reused
+    const std::vector<Graph::edge_descriptor>   emptyPath_;
+    std::chrono::nanoseconds                    checkTime_;     // time passed since the last check of free couriers
+    int                                         deliveryTime_;  // delivery time of the deadlines in 'targets_', seconds
+    unsigned long long int                      routedOrders_;
 };
 
 } // namespace ds
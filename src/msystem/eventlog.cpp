@@ -0,0 +1,688 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"eventlog.hpp"
+#include"options.hpp"
+#include<assert.h>
+#include<cstring>
+#include<iterator>
+#include<limits>
+#include<type_traits>
+#include<utility>
+
+namespace ds {
+
+using namespace std;
+
+namespace {
+
+constexpr char logMagic[8]{ 'P', 'Z', 'D', 'S', 'L', 'O', 'G', '\0' };
+constexpr unsigned long long int logVersion{ 2 };
+
+// FNV-1a over the bytes of the values
+class StateHash {
+public:
+    template <class T>
+    void add(const T& value) noexcept
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        unsigned char bytes[sizeof(T)];
+        memcpy(bytes, &value, sizeof(T));
+        for (const unsigned char b : bytes) {
+            hash_ ^= b;
+            hash_ *= 1099511628211ull;
+        }
+    }
+
+    unsigned long long int get() const noexcept { return hash_; }
+
+private:
+    unsigned long long int                      hash_{ 14695981039346656037ull };
+};
+
+// reader of the variable-length integers, a read past the end makes it invalid
+class LogReader {
+public:
+    explicit LogReader(const vector<unsigned char>& data) noexcept
+        :
+        data_       { data },
+        pos_        { 0 },
+        isValid_    { true }
+    {}
+
+    bool isEnd() const noexcept { return pos_ >= data_.size(); }
+
+    bool isValid() const noexcept { return isValid_; }
+
+    void invalidate() noexcept { isValid_ = false; }
+
+    unsigned char readByte() noexcept
+    {
+        if (isEnd()) {
+            isValid_ = false;
+            return 0;
+        }
+        return data_[pos_++];
+    }
+
+    unsigned long long int readUnsigned() noexcept
+    {
+        unsigned long long int value{ 0 };
+        for (unsigned int shift = 0; shift < 64; shift += 7) {
+            const unsigned char b{ readByte() };
+            value |= static_cast<unsigned long long int>(b & 0x7f) << shift;
+            if ((b & 0x80) == 0) {
+                return value;
+            }
+        }
+        isValid_ = false;
+        return value;
+    }
+
+    long long int readSigned() noexcept
+    {
+        const unsigned long long int value{ readUnsigned() };
+        return static_cast<long long int>(value >> 1) ^ -static_cast<long long int>(value & 1);
+    }
+
+private:
+    const vector<unsigned char>&                data_;
+    size_t                                      pos_;
+    bool                                        isValid_;
+};
+
+Graph readGraph(LogReader& reader)
+{
+    Graph graph{};
+    const unsigned long long int numVertices{ reader.readUnsigned() };
+    for (unsigned long long int v = 0; v < numVertices && reader.isValid(); ++v) {
+        const int num{ int(reader.readSigned()) };
+        const int x{ int(reader.readSigned()) };
+        const int y{ int(reader.readSigned()) };
+        boost::add_vertex(GraphVertexPropertyMap{ num, x, y }, graph);
+    }
+    for (unsigned long long int v = 0; v < numVertices && reader.isValid(); ++v) {
+        const unsigned long long int numEdges{ reader.readUnsigned() };
+        for (unsigned long long int e = 0; e < numEdges && reader.isValid(); ++e) {
+            const unsigned long long int target{ reader.readUnsigned() };
+            const int num{ int(reader.readSigned()) };
+            const int distance{ int(reader.readSigned()) };
+            const int time{ int(reader.readSigned()) };
+            if (target >= numVertices) {
+                reader.invalidate();
+                break;
+            }
+            boost::add_edge(size_t(v), size_t(target), GraphEdgePropertyMap{ num, distance, time }, graph);
+        }
+    }
+    return graph;
+}
+
+struct RecordedOrder {
+    size_t                                      target_;
+    bool                                        isPaid_;
+    Order::food_list_t                          food_;
+};
+
+bool isSameOrder(const Order& order, const RecordedOrder& recorded)
+{
+    if (order.getTarget() != recorded.target_ || order.isPaid() != recorded.isPaid_
+        || order.getFood().size() != recorded.food_.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < recorded.food_.size(); ++i) {
+        if (order.getFood()[i].getName() != recorded.food_[i].getName()
+            || order.getFood()[i].getQuantity() != recorded.food_[i].getQuantity())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+option_values_t takeOptions(const OptionsSimulation& options)
+{
+    return {
+        options.optDelivery_.deliveryTime_,
+        options.optDelivery_.checkTimeFreeCour_,
+        options.optDelivery_.maxRouteLabels_,
+        options.optDelivery_.maxRouteTime_,
+        int(options.optDelivery_.lateInsertion_),
+        options.optCourier_.pauseTime_,
+        options.optCourier_.pauseChance_,
+        options.optCourier_.acceptanceTime_,
+        options.optCourier_.deliveryTime_,
+        options.optCourier_.paymentTime_,
+        options.optCourier_.averageSpeed_,
+        options.optGenerator_.profile_,
+        options.optGenerator_.orderRate_,
+        options.optGenerator_.startHour_,
+        options.optGenerator_.burstFactor_,
+        options.optGenerator_.numHotspots_,
+        options.optGenerator_.hotspotShare_,
+    };
+}
+
+void applyOptions(const option_values_t& values, OptionsSimulation& options)
+{
+    size_t i{ 0 };
+    options.optDelivery_.deliveryTime_      = values[i++];
+    options.optDelivery_.checkTimeFreeCour_ = values[i++];
+    options.optDelivery_.maxRouteLabels_    = values[i++];
+    options.optDelivery_.maxRouteTime_      = values[i++];
+    options.optDelivery_.lateInsertion_     = values[i++] != 0;
+    options.optCourier_.pauseTime_          = values[i++];
+    options.optCourier_.pauseChance_        = values[i++];
+    options.optCourier_.acceptanceTime_     = values[i++];
+    options.optCourier_.deliveryTime_       = values[i++];
+    options.optCourier_.paymentTime_        = values[i++];
+    options.optCourier_.averageSpeed_       = values[i++];
+    options.optGenerator_.profile_          = values[i++];
+    options.optGenerator_.orderRate_        = values[i++];
+    options.optGenerator_.startHour_        = values[i++];
+    options.optGenerator_.burstFactor_      = values[i++];
+    options.optGenerator_.numHotspots_      = values[i++];
+    options.optGenerator_.hotspotShare_     = values[i++];
+    assert(i == values.size());
+}
+
+string_view toString(EventType value) noexcept
+{
+    switch (value) {
+    case EventType::__INVALID:
+        return u8"INVALID";
+    case EventType::SEED:
+        return u8"Seed";
+    case EventType::OPTIONS:
+        return u8"Options";
+    case EventType::MAP:
+        return u8"Map";
+    case EventType::UPDATE:
+        return u8"Update";
+    case EventType::REPEAT:
+        return u8"Repeat";
+    case EventType::ORDER:
+        return u8"Order";
+    case EventType::COURIER:
+        return u8"Courier";
+    case EventType::KITCHENER:
+        return u8"Kitchener";
+    case EventType::END:
+        return u8"End";
+    default:
+        return u8"UNKNOWN";
+    }
+    static_assert(cmn::numberOf<EventType>() == 9);
+}
+
+///************************************************************************************************
+
+EventLog::EventLog(const string& fileName)
+    :
+    file_           { fileName, ios::binary },
+    buffer_         {},
+    options_        {},
+    mapVersion_     { 0 },
+    timeouts_       { 0 },
+    events_         { 0 },
+    passedTime_     { -1 },
+    repeats_        { 0 }
+{
+    // an event is added to the buffer before it is written, so the buffer never grows in a long run
+    buffer_.reserve(2 * bufferSize_);
+}
+
+EventLog::~EventLog() noexcept
+{
+    if (file_.is_open()) {
+        this->addRepeats();
+        this->flush();
+    }
+}
+
+void EventLog::start(const ManagmentSystem& ms)
+{
+    assert(events_ == 0);
+    buffer_.insert(buffer_.end(), begin(logMagic), end(logMagic));
+    writeUnsigned(logVersion);
+    writeUnsigned(ms.scheduler().getOffice());
+
+    // the numbers are repeated from the recorded seed
+    const unsigned int seed{ cmn::getRandomSeed() };
+    cmn::seedRandomNumbers(seed);
+    addSeed(seed);
+
+    options_ = takeOptions(ms.options());
+    addOptions();
+    mapVersion_ = ms.map().getVersion();
+    addMap(ms.map());
+    timeouts_ = ms.map().getNumberOfTimeouts();
+}
+
+void EventLog::addChanges(const ManagmentSystem& ms)
+{
+    const option_values_t options{ takeOptions(ms.options()) };
+    if (options != options_) {
+        options_ = options;
+        addOptions();
+    }
+    if (ms.map().getVersion() != mapVersion_) {
+        mapVersion_ = ms.map().getVersion();
+        addMap(ms.map());
+    }
+}
+
+void EventLog::addSeed(unsigned int seed)
+{
+    addEvent(EventType::SEED);
+    writeUnsigned(seed);
+}
+
+void EventLog::addUpdate(const ManagmentSystem& ms, chrono::nanoseconds passedTime)
+{
+    assert(passedTime.count() >= 0);
+    addChanges(ms);
+    if (passedTime == passedTime_) {
+        ++repeats_;
+        return;
+    }
+    addEvent(EventType::UPDATE);
+    writeUnsigned(static_cast<unsigned long long int>(passedTime.count()));
+    passedTime_ = passedTime;
+}
+
+void EventLog::addOrder(const ManagmentSystem& ms, const Order& order, OrderOrigin origin)
+{
+    addChanges(ms);
+    addEvent(EventType::ORDER);
+    writeByte(static_cast<unsigned char>(origin));
+    writeUnsigned(order.getTarget());
+    // the order may arrive between the updates
+    writeUnsigned(static_cast<unsigned long long int>(order.getTimeStart() - ms.getCurrentTick()));
+    writeByte(order.isPaid() ? 1 : 0);
+    writeUnsigned(order.getFood().size());
+    for (const Food& food : order.getFood()) {
+        writeByte(static_cast<unsigned char>(food.getName()));
+        writeUnsigned(food.getQuantity());
+    }
+}
+
+void EventLog::addCourier(const ManagmentSystem& ms, WorkerID workerID, bool isActivated)
+{
+    addChanges(ms);
+    addEvent(EventType::COURIER);
+    writeUnsigned(cmn::toUnderlying(workerID));
+    writeByte(isActivated ? 1 : 0);
+}
+
+void EventLog::addKitchener(const ManagmentSystem& ms, WorkerID workerID, KitchenerType type, bool isActivated)
+{
+    addChanges(ms);
+    addEvent(EventType::KITCHENER);
+    writeUnsigned(cmn::toUnderlying(workerID));
+    writeByte(static_cast<unsigned char>(type));
+    writeByte(isActivated ? 1 : 0);
+}
+
+bool EventLog::finish(const ManagmentSystem& ms)
+{
+    addEvent(EventType::END);
+    writeUnsigned(hashState(ms));
+    writeUnsigned(ms.map().getNumberOfTimeouts() - timeouts_);
+    this->flush();
+    file_.close();
+    return file_.fail() == false;
+}
+
+void EventLog::addEvent(EventType type)
+{
+    if (buffer_.size() >= bufferSize_) {
+        this->flush();
+    }
+    // the counted updates precede any other event
+    this->addRepeats();
+    writeByte(static_cast<unsigned char>(type));
+    ++events_;
+}
+
+void EventLog::addRepeats()
+{
+    if (repeats_ > 0) {
+        writeByte(static_cast<unsigned char>(EventType::REPEAT));
+        writeUnsigned(repeats_);
+        ++events_;
+        repeats_ = 0;
+    }
+}
+
+void EventLog::addOptions()
+{
+    addEvent(EventType::OPTIONS);
+    writeUnsigned(options_.size());
+    for (const int value : options_) {
+        writeSigned(value);
+    }
+}
+
+void EventLog::addMap(const Map& map)
+{
+    const Graph& graph{ map.graph() };
+    addEvent(EventType::MAP);
+    writeUnsigned(graph.m_vertices.size());
+    for (const auto& vertex : graph.m_vertices) {
+        writeSigned(vertex.m_property.num_);
+        writeSigned(vertex.m_property.x_);
+        writeSigned(vertex.m_property.y_);
+    }
+    // the edges keep their order, so the replayed searches visit them in the same order
+    for (size_t v = 0; v < graph.m_vertices.size(); ++v) {
+        writeUnsigned(graph.m_vertices[v].m_out_edges.size());
+        for (auto [iter, end]{ boost::out_edges(v, graph) }; iter != end; ++iter) {
+            const GraphEdgePropertyMap& edge{ graph[*iter] };
+            writeUnsigned(boost::target(*iter, graph));
+            writeSigned(edge.num_);
+            writeSigned(edge.distance_);
+            writeSigned(edge.time_);
+        }
+    }
+}
+
+void EventLog::writeUnsigned(unsigned long long int value)
+{
+    while (value >= 0x80) {
+        writeByte(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    writeByte(static_cast<unsigned char>(value));
+}
+
+void EventLog::writeSigned(long long int value)
+{
+    // zigzag, the small negative values are short too
+    writeUnsigned((static_cast<unsigned long long int>(value) << 1) ^ static_cast<unsigned long long int>(value >> 63));
+}
+
+void EventLog::flush()
+{
+    if (buffer_.empty() == false) {
+        file_.write(reinterpret_cast<const char*>(buffer_.data()), streamsize(buffer_.size()));
+        buffer_.clear();
+    }
+}
+
+///************************************************************************************************
+
+unsigned long long int hashState(const ManagmentSystem& ms)
+{
+    StateHash hash{};
+    hash.add(ms.getCurrentTick());
+    for (auto [iter, end]{ ms.getOrders() }; iter != end; ++iter) {
+        const Order& order{ **iter };
+        hash.add(order.getID());
+        hash.add(order.getStatus());
+        hash.add(order.isPaid());
+        hash.add(order.getTimeEnd());
+        hash.add(order.getReadyTime());
+        for (const Food& food : order.getFood()) {
+            hash.add(food.getName());
+            hash.add(food.getStatus());
+        }
+    }
+    for (auto [iter, end]{ ms.getCouriers() }; iter != end; ++iter) {
+        const Courier& courier{ **iter };
+        hash.add(courier.getID());
+        hash.add(courier.getStatus());
+        hash.add(courier.getCurrentLocation().x);
+        hash.add(courier.getCurrentLocation().y);
+        if (courier.getStatus() == CourierStatus::ACCEPTING_ORDER) {
+            hash.add(courier.getTimeToDeparture().count());
+        }
+    }
+    for (auto [iter, end]{ ms.getKitcheners() }; iter != end; ++iter) {
+        const Kitchener& kitchener{ **iter };
+        hash.add(kitchener.getID());
+        hash.add(kitchener.getType());
+        hash.add(kitchener.getStatus());
+        hash.add(kitchener.getFood() == nullptr ? OrderID{ numeric_limits<unsigned long long int>::max() }
+                                                : ms.kitchen().getOrder(kitchener.getFood()).getID());
+    }
+    for (char t = 0; t < cmn::numberOf<KitchenerType>(); ++t) {
+        hash.add(ms.kitchen().getQueueSize(static_cast<KitchenerType>(t)));
+    }
+    for (char s = 0; s < cmn::numberOf<CourierStatus>(); ++s) {
+        hash.add(ms.delivery().getNumberOfCouriers(static_cast<CourierStatus>(s)));
+    }
+    return hash.get();
+}
+
+bool replayEventLog(const string& fileName, ReplayResult& result)
+{
+    using namespace std::chrono;
+
+    result = ReplayResult{};
+    result.divergentOrder_ = numeric_limits<size_t>::max();
+    vector<unsigned char> data{};
+    {
+        ifstream file{ fileName, ios::binary };
+        if (file.is_open() == false) {
+            result.error_ = u8"can not open the file";
+            return false;
+        }
+        data.assign(istreambuf_iterator<char>{ file }, istreambuf_iterator<char>{});
+    }
+    LogReader reader{ data };
+    for (const char c : logMagic) {
+        if (reader.readByte() != static_cast<unsigned char>(c)) {
+            result.error_ = u8"not an event log";
+            return false;
+        }
+    }
+    if (reader.readUnsigned() != logVersion) {
+        result.error_ = u8"unknown version of the log";
+        return false;
+    }
+    const unsigned long long int office{ reader.readUnsigned() };
+
+    // the system is built as in the recording, the map is replaced by the recorded one
+    Map map{};
+    Scheduler scheduler{ Graph::vertex_descriptor(office) };
+    Kitchen kitchen{};
+    Delivery delivery{};
+    ManagmentSystem ms{ map, scheduler, kitchen, delivery, OptionsSimulation{} };
+    scheduler.setManagmentSystem(&ms);
+    kitchen.setManagmentSystem(&ms);
+    delivery.setManagmentSystem(&ms);
+
+    vector<RecordedOrder> recordedOrders{};
+    size_t checkedOrders{ 0 };
+    auto checkOrders{ [&]() {
+        const auto [begin, end]{ ms.getOrders() };
+        for (; checkedOrders < recordedOrders.size() && begin + checkedOrders < end; ++checkedOrders) {
+            if (result.divergentOrder_ == numeric_limits<size_t>::max()
+                && isSameOrder(*begin[checkedOrders], recordedOrders[checkedOrders]) == false)
+            {
+                result.divergentOrder_ = checkedOrders;
+            }
+        }
+    } };
+
+    // the orders taken from the intake are recorded during the update, so the update is
+    // held until its orders are submitted
+    nanoseconds passedTime{ 0 };
+    bool isUpdatePending{ false };
+    auto runUpdate{ [&]() {
+        if (isUpdatePending) {
+            ms.update(passedTime);
+            ++result.updates_;
+            isUpdatePending = false;
+            checkOrders();
+        }
+    } };
+
+    // every event is read whole before it is applied, so a log cut by a crash is replayed up to the cut
+    const auto start{ steady_clock::now() };
+    while (reader.isEnd() == false && reader.isValid() && result.isComplete_ == false) {
+        const auto type{ static_cast<EventType>(reader.readByte()) };
+        ++result.events_;
+        switch (type) {
+        case EventType::SEED: {
+            const auto seed{ static_cast<unsigned int>(reader.readUnsigned()) };
+            if (reader.isValid()) {
+                runUpdate();
+                cmn::seedRandomNumbers(seed);
+            }
+            break;
+        }
+        case EventType::OPTIONS: {
+            option_values_t values{};
+            if (reader.readUnsigned() != values.size()) {
+                reader.invalidate();
+                break;
+            }
+            for (int& value : values) {
+                value = int(reader.readSigned());
+            }
+            if (reader.isValid()) {
+                runUpdate();
+                // the recorded options were taken at the start of the next update, so are the replayed ones
+                OptionsSimulation options{ ms.options() };
+                applyOptions(values, options);
+                ms.setOptions(options);
+            }
+            break;
+        }
+        case EventType::MAP: {
+            Graph graph{ readGraph(reader) };
+            if (reader.isValid()) {
+                runUpdate();
+                map.setGraph(std::move(graph));
+            }
+            break;
+        }
+        case EventType::UPDATE: {
+            const nanoseconds time{ static_cast<long long int>(reader.readUnsigned()) };
+            if (reader.isValid()) {
+                runUpdate();
+                passedTime = time;
+                isUpdatePending = true;
+            }
+            break;
+        }
+        case EventType::REPEAT: {
+            // the intake of the last repeated update may follow
+            const unsigned long long int repeats{ reader.readUnsigned() };
+            for (unsigned long long int i = 0; i < repeats && reader.isValid(); ++i) {
+                runUpdate();
+                isUpdatePending = true;
+            }
+            break;
+        }
+        case EventType::ORDER: {
+            const auto origin{ static_cast<OrderOrigin>(reader.readByte()) };
+            RecordedOrder recorded{};
+            recorded.target_ = size_t(reader.readUnsigned());
+            const cmn::tick_t arrival{ static_cast<cmn::tick_t>(reader.readUnsigned()) };
+            recorded.isPaid_ = reader.readByte() != 0;
+            const unsigned long long int numFood{ reader.readUnsigned() };
+            if (numFood > Order::maxFood_) {
+                reader.invalidate();
+                break;
+            }
+            for (unsigned long long int i = 0; i < numFood; ++i) {
+                const auto name{ static_cast<FoodName>(reader.readByte()) };
+                const auto quantity{ static_cast<unsigned short>(reader.readUnsigned()) };
+                recorded.food_.push_back(Food{ quantity, name });
+            }
+            if (reader.isValid() == false) {
+                break;
+            }
+            if (cmn::isValidEnum(origin) == false || recorded.target_ >= map.graph().m_vertices.size()) {
+                reader.invalidate();
+                break;
+            }
+            recordedOrders.push_back(recorded);
+            if (origin == OrderOrigin::INTAKE) {
+                ms.submitOrder(OrderRequest{ recorded.target_ });
+                break;
+            }
+            runUpdate();
+            if (origin == OrderOrigin::RANDOM) {
+                ms.createOrder();
+            }
+            else {
+                ms.createOrder(recorded.target_, ms.getCurrentTick() + arrival);
+            }
+            checkOrders();
+            break;
+        }
+        case EventType::COURIER: {
+            const WorkerID workerID{ static_cast<unsigned int>(reader.readUnsigned()) };
+            const bool isActivated{ reader.readByte() != 0 };
+            if (reader.isValid() == false) {
+                break;
+            }
+            runUpdate();
+            if (isActivated) {
+                ms.activateCourier(workerID);
+            }
+            else {
+                ms.deactivateCourier(workerID);
+            }
+            break;
+        }
+        case EventType::KITCHENER: {
+            const WorkerID workerID{ static_cast<unsigned int>(reader.readUnsigned()) };
+            const auto kitchenerType{ static_cast<KitchenerType>(reader.readByte()) };
+            const bool isActivated{ reader.readByte() != 0 };
+            if (reader.isValid() == false) {
+                break;
+            }
+            if (cmn::isValidEnum(kitchenerType) == false) {
+                reader.invalidate();
+                break;
+            }
+            runUpdate();
+            if (isActivated) {
+                ms.activateKitchener(workerID, kitchenerType);
+            }
+            else {
+                ms.deactivateKitchener(workerID);
+            }
+            break;
+        }
+        case EventType::END:
+            result.recordedHash_ = reader.readUnsigned();
+            result.recordedTimeouts_ = reader.readUnsigned();
+            if (reader.isValid()) {
+                runUpdate();
+                result.isComplete_ = true;
+            }
+            break;
+        default:
+            reader.invalidate();
+            break;
+        }
+    }
+    if (reader.isValid() == false) {
+        if (reader.isEnd() == false) {
+            result.error_ = u8"the event " + to_string(result.events_) + u8" is broken";
+            return false;
+        }
+        // the last event is cut, the log is incomplete
+        --result.events_;
+    }
+    runUpdate();
+    result.wallTime_ = duration_cast<duration<double>>(steady_clock::now() - start).count();
+    result.orders_ = ms.orderTable().size();
+    result.tick_ = ms.getCurrentTick();
+    result.hash_ = hashState(ms);
+    result.timeouts_ = map.getNumberOfTimeouts();
+    return true;
+}
+
+} // namespace ds
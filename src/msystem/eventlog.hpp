@@ -0,0 +1,153 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EVENT_LOG_HPP
+#define EVENT_LOG_HPP
+
+#include"common.hpp"
+#include"kitchener.hpp"
+#include"msystem.hpp"
+#include"order.hpp"
+#include"worker.hpp"
+#include<array>
+#include<chrono>
+#include<fstream>
+#include<string>
+#include<string_view>
+#include<vector>
+
+namespace ds {
+
+enum class EventType : char {
+    __INVALID = -1,                 /// invalid, must be the first
+    // vvv EVENTS vvv
+    SEED,                           /// seed of the random numbers
+    OPTIONS,                        /// options of the simulation
+    MAP,                            /// whole graph of the map
+    UPDATE,                         /// passed time
+    REPEAT,                         /// number of updates with the same passed time as the previous one
+    ORDER,                          /// origin, target, arrival and contents of a new order
+    COURIER,                        /// activation or deactivation
+    KITCHENER,                      /// activation or deactivation
+    END,                            /// hash of the final state
+    // ^^^ EVENTS ^^^
+    __NUMBER_OF,
+    __END                           /// must be the last
+};
+
+std::string_view toString(EventType value) noexcept;
+
+///************************************************************************************************
+
+// Recorder of all external inputs of a managment system to a compact binary file: the seed,
+// the options and the map as they change, the passed time of every update, the new orders and
+// the changes of the workers. The integers are written as variable-length ones and the updates
+// with the same passed time are counted, so a run with a fixed step takes a few bytes per order.
+// The events are buffered and written in blocks, a recorded update allocates nothing.
+// The system is replayed by 'replayEventLog'.
+class EventLog {
+public:
+    static constexpr size_t bufferSize_{ 1 << 16 };             // bytes written at once
+    static constexpr size_t numberOfOptions_{ 17 };             // recorded options of the simulation
+
+public:
+    explicit EventLog(const std::string& fileName);
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    // the buffered events are written, a log without the end can be replayed anyway
+    virtual ~EventLog() noexcept;
+
+public:
+    bool isOpen() const { return file_.is_open(); }
+
+    // the random numbers of the thread are seeded again with the recorded seed,
+    // the options, the map and the active workers of the system are the initial state
+    void start(const ManagmentSystem& ms);
+
+    // the options and the map are recorded if they were changed since the last event
+    void addChanges(const ManagmentSystem& ms);
+
+    // the random numbers of the thread are seeded again, e.g. by a checkpoint
+    void addSeed(unsigned int seed);
+
+    void addUpdate(const ManagmentSystem& ms, std::chrono::nanoseconds passedTime);
+
+    void addOrder(const ManagmentSystem& ms, const Order& order, OrderOrigin origin);
+
+    void addCourier(const ManagmentSystem& ms, WorkerID workerID, bool isActivated);
+
+    void addKitchener(const ManagmentSystem& ms, WorkerID workerID, KitchenerType type, bool isActivated);
+
+    // the hash of the state ends the log, the file is closed; returns false if it can not be written
+    bool finish(const ManagmentSystem& ms);
+
+    unsigned long long int getNumberOfEvents() const noexcept { return events_; }
+
+private:
+    void addEvent(EventType type);
+
+    void addRepeats();
+
+    void addOptions();
+
+    void addMap(const Map& map);
+
+    void writeByte(unsigned char value) { buffer_.push_back(value); }
+
+    void writeUnsigned(unsigned long long int value);
+
+    void writeSigned(long long int value);
+
+    void flush();
+
+private:
+    std::ofstream                               file_;
+    std::vector<unsigned char>                  buffer_;        // events to be written
+    std::array<int, numberOfOptions_>           options_;       // the last recorded options
+    unsigned long long int                      mapVersion_;    // version of the last recorded map
+    unsigned long long int                      timeouts_;      // route searches stopped by the time before the start
+    unsigned long long int                      events_;
+    std::chrono::nanoseconds                    passedTime_;    // of the last recorded update
+    unsigned long long int                      repeats_;       // updates not written yet
+};
+
+///************************************************************************************************
+
+using option_values_t = std::array<int, EventLog::numberOfOptions_>;
+
+// the options that change the simulation, the options of the presentation are not recorded
+option_values_t takeOptions(const OptionsSimulation& options);
+
+void applyOptions(const option_values_t& values, OptionsSimulation& options);
+
+///************************************************************************************************
+
+struct ReplayResult {
+    unsigned long long int                      events_;
+    unsigned long long int                      updates_;
+    size_t                                      orders_;
+    cmn::tick_t                                 tick_;          // the final time of the simulation
+    double                                      wallTime_;      // seconds
+    unsigned long long int                      hash_;          // of the final state
+    unsigned long long int                      recordedHash_;
+    unsigned long long int                      timeouts_;      // route searches stopped by the time in the replay
+    unsigned long long int                      recordedTimeouts_;
+    size_t                                      divergentOrder_; // the first order created otherwise than recorded
+    bool                                        isComplete_;    // the log has the end
+    std::string                                 error_;         // the reason of a failed replay
+};
+
+// hash of the orders, the workers and the queues, the same inputs give the same hash
+unsigned long long int hashState(const ManagmentSystem& ms);
+
+// the log is re-executed headless as fast as possible with its own system;
+// returns false if the file can not be read or is not a valid log
+bool replayEventLog(const std::string& fileName, ReplayResult& result);
+
+} // namespace ds
+
+#endif // !EVENT_LOG_HPP
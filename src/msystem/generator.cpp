@@ -0,0 +1,220 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"generator.hpp"
+#include"options.hpp"
+#include<algorithm>
+#include<assert.h>
+#include<cmath>
+#include<iterator>
+
+namespace ds {
+
+using namespace std;
+
+namespace {
+
+constexpr double secondsPerHour{ 60.0 * 60.0 };
+constexpr double hoursPerDay{ 24.0 };
+
+// diurnal profile, the base rate plus the peaks of the normal shape
+constexpr double diurnalBase{ 0.25 };
+constexpr double lunchPeak{ 1.5 };
+constexpr double lunchHour{ 12.5 };
+constexpr double lunchWidth{ 1.0 };             // hours
+constexpr double dinnerPeak{ 2.0 };
+constexpr double dinnerHour{ 19.0 };
+constexpr double dinnerWidth{ 1.5 };            // hours
+
+// burst profile, a burst at the beginning of every hour
+constexpr double burstLength{ 10.0 / 60.0 };    // hours
+
+double getPeak(double hour, double peakHour, double width)
+{
+    double distance{ abs(hour - peakHour) };
+    distance = min(distance, hoursPerDay - distance);
+    return exp(-0.5 * (distance / width) * (distance / width));
+}
+
+double getDiurnalMean()
+{
+    const double sqrt2Pi{ sqrt(2.0 * acos(-1.0)) };
+    return diurnalBase + (lunchPeak * lunchWidth + dinnerPeak * dinnerWidth) * sqrt2Pi / hoursPerDay;
+}
+
+// computed once at the start of the program, so the rate needs no guarded static
+const double diurnalMean{ getDiurnalMean() };
+
+} // namespace
+
+string_view toString(ArrivalProfile value) noexcept
+{
+    switch (value) {
+    case ArrivalProfile::__INVALID:
+        return u8"INVALID";
+    case ArrivalProfile::POISSON:
+        return u8"Poisson";
+    case ArrivalProfile::DIURNAL:
+        return u8"Diurnal";
+    case ArrivalProfile::BURST:
+        return u8"Burst";
+    default:
+        return u8"UNKNOWN";
+    }
+    static_assert(cmn::numberOf<ArrivalProfile>() == 3);
+}
+
+///************************************************************************************************
+
+OrderGenerator::OrderGenerator(ManagmentSystem& ms, unsigned long long int seed)
+    :
+    ms_             { ms },
+    engine_         { seed },
+    hotspots_       {},
+    numVertices_    { 0 },
+    fixedHotspots_  { false },
+    time_           { 0 },
+    nextArrival_    { 0 },
+    maxRate_        { 0.0 }
+{}
+
+size_t OrderGenerator::update(chrono::nanoseconds passedTime)
+{
+    const OptionsGenerator& options{ ms_.options().optGenerator_ };
+    const auto profile{ static_cast<ArrivalProfile>(options.profile_) };
+    const double maxRate{ options.orderRate_ * getMaxMultiplier(profile, options.burstFactor_) };
+    if (maxRate != maxRate_) {
+        // the process is memoryless, the next arrival is drawn again with the new bound
+        maxRate_ = maxRate;
+        nextArrival_ = time_ + getInterval();
+    }
+    time_ += cmn::toTicks(passedTime);
+    if (ms_.map().graph().m_vertices.size() < 2) {
+        nextArrival_ = max(nextArrival_, time_);
+        return 0;
+    }
+    updateHotspots();
+
+    size_t created{ 0 };
+    while (nextArrival_ <= time_) {
+        if (cmn::getRandomReal(engine_) * maxRate_ < getRate(nextArrival_)) {
+            // the order is stamped with its arrival, not with the end of the passed time
+            ms_.createOrder(selectTarget(), nextArrival_);
+            ++created;
+        }
+        nextArrival_ += getInterval();
+    }
+    return created;
+}
+
+double OrderGenerator::getRate(cmn::tick_t tick) const
+{
+    const OptionsGenerator& options{ ms_.options().optGenerator_ };
+    const double hours{ double(tick) / cmn::ticksPerSecond / secondsPerHour + options.startHour_ };
+    return options.orderRate_ * getMultiplier(static_cast<ArrivalProfile>(options.profile_),
+        fmod(hours, hoursPerDay), options.burstFactor_);
+}
+
+void OrderGenerator::setHotspots(const vector<size_t>& hotspots)
+{
+    assert(all_of(hotspots.cbegin(), hotspots.cend(),
+        [this](size_t hotspot) { return hotspot < ms_.map().graph().m_vertices.size(); }));
+    // the office is never the target of an order
+    const size_t office{ ms_.scheduler().getOffice() };
+    hotspots_.clear();
+    copy_if(hotspots.cbegin(), hotspots.cend(), back_inserter(hotspots_),
+        [office](size_t hotspot) { return hotspot != office; });
+    fixedHotspots_ = hotspots_.empty() == false;
+    numVertices_ = 0;
+}
+
+double OrderGenerator::getMultiplier(ArrivalProfile profile, double hour, double burstFactor)
+{
+    switch (profile) {
+    case ArrivalProfile::POISSON:
+        return 1.0;
+    case ArrivalProfile::DIURNAL: {
+        return (diurnalBase + lunchPeak * getPeak(hour, lunchHour, lunchWidth)
+            + dinnerPeak * getPeak(hour, dinnerHour, dinnerWidth)) / diurnalMean;
+    }
+    case ArrivalProfile::BURST: {
+        const double base{ 1.0 / (1.0 - burstLength + burstLength * burstFactor) };
+        return hour - floor(hour) < burstLength ? base * burstFactor : base;
+    }
+    default:
+        assert(false);
+        return 1.0;
+    }
+}
+
+double OrderGenerator::getMaxMultiplier(ArrivalProfile profile, double burstFactor)
+{
+    if (profile == ArrivalProfile::DIURNAL) {
+        return (diurnalBase + lunchPeak + dinnerPeak) / getDiurnalMean();
+    }
+    // the constant rate and the burst rate at the beginning of an hour are the maximum ones
+    return getMultiplier(profile, 0.0, burstFactor);
+}
+
+cmn::tick_t OrderGenerator::getInterval()
+{
+    const double ticks{ cmn::getRandomExponential(engine_, maxRate_ / secondsPerHour) * cmn::ticksPerSecond };
+    return ticks < double(cmn::maxTick / 2) ? max(cmn::tick_t{ 1 }, cmn::tick_t(ticks)) : cmn::maxTick / 2;
+}
+
+size_t OrderGenerator::selectTarget()
+{
+    const OptionsGenerator& options{ ms_.options().optGenerator_ };
+    if (hotspots_.empty()
+        || cmn::getRandomIndex(engine_, 100) >= static_cast<unsigned long long int>(options.hotspotShare_))
+    {
+        return selectVertex();
+    }
+
+    // the hotspot covers its vertex and the adjacent vertices
+    const Graph& graph{ ms_.map().graph() };
+    const size_t office{ ms_.scheduler().getOffice() };
+    const size_t hotspot{ hotspots_[size_t(cmn::getRandomIndex(engine_, hotspots_.size()))] };
+    const auto& edges{ graph.m_vertices[hotspot].m_out_edges };
+    const size_t area{ size_t(cmn::getRandomIndex(engine_, edges.size() + 1)) };
+    const size_t target{ area == edges.size() ? hotspot : edges[area].m_target };
+    return target == office ? hotspot : target;
+}
+
+size_t OrderGenerator::selectVertex()
+{
+    // the target of an order is never the office
+    const size_t office{ ms_.scheduler().getOffice() };
+    const size_t vertex{ size_t(cmn::getRandomIndex(engine_, ms_.map().graph().m_vertices.size() - 1)) };
+    return vertex >= office ? vertex + 1 : vertex;
+}
+
+void OrderGenerator::updateHotspots()
+{
+    const size_t numVertices{ ms_.map().graph().m_vertices.size() };
+    if (fixedHotspots_) {
+        if (numVertices_ != numVertices) {
+            // removed vertices can not be hotspots
+            hotspots_.erase(remove_if(hotspots_.begin(), hotspots_.end(),
+                [numVertices](size_t hotspot) { return hotspot >= numVertices; }), hotspots_.end());
+            numVertices_ = numVertices;
+        }
+        return;
+    }
+    const size_t numHotspots{ min(size_t(ms_.options().optGenerator_.numHotspots_), numVertices - 1) };
+    if (numVertices_ == numVertices && hotspots_.size() == numHotspots) {
+        return;
+    }
+    hotspots_.clear();
+    while (hotspots_.size() < numHotspots) {
+        const size_t vertex{ selectVertex() };
+        if (find(hotspots_.cbegin(), hotspots_.cend(), vertex) == hotspots_.cend()) {
+            hotspots_.push_back(vertex);
+        }
+    }
+    numVertices_ = numVertices;
+}
+
+} // namespace ds
@@ -0,0 +1,91 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef GENERATOR_HPP
+#define GENERATOR_HPP
+
+#include"common.hpp"
+#include"msystem.hpp"
+#include<chrono>
+#include<random>
+#include<string_view>
+#include<vector>
+
+namespace ds {
+
+enum class ArrivalProfile : char {
+    __INVALID = -1,                 /// invalid, must be the first
+    // vvv PROFILES vvv
+    POISSON,                        /// constant rate
+    DIURNAL,                        /// lunch and dinner peaks
+    BURST,                          /// short bursts at the beginning of every hour
+    // ^^^ PROFILES ^^^
+    __NUMBER_OF,
+    __END                           /// must be the last
+};
+
+std::string_view toString(ArrivalProfile value) noexcept;
+
+///************************************************************************************************
+
+// Synthetic order arrivals, a non-homogeneous Poisson process sampled by thinning,
+// the rate of all profiles averages to the configured number of orders per hour
+class OrderGenerator {
+public:
+    explicit OrderGenerator(ManagmentSystem& ms, unsigned long long int seed = std::random_device{}());
+
+    OrderGenerator(const OrderGenerator&) = delete;
+    OrderGenerator& operator=(const OrderGenerator&) = delete;
+
+    virtual ~OrderGenerator() noexcept {}
+
+public:
+    // creates the orders arrived during the passed time, returns their number
+    size_t update(std::chrono::nanoseconds passedTime);
+
+    // orders per hour at the tick of the generator
+    double getRate(cmn::tick_t tick) const;
+
+    const std::vector<size_t>& getHotspots() const noexcept { return hotspots_; }
+
+    // fixes the hotspots, the random hotspots are used again after an empty list
+    void setHotspots(const std::vector<size_t>& hotspots);
+
+    void seed(unsigned long long int seed) { engine_.seed(seed); }
+
+    // the arrivals go on from the tick, e.g. of a restored system, the next arrival is drawn anew
+    void setTime(cmn::tick_t tick) noexcept
+    {
+        time_ = tick;
+        maxRate_ = 0.0;
+    }
+
+private:
+    static double getMultiplier(ArrivalProfile profile, double hour, double burstFactor);
+
+    static double getMaxMultiplier(ArrivalProfile profile, double burstFactor);
+
+    cmn::tick_t getInterval();
+
+    size_t selectTarget();
+
+    size_t selectVertex();
+
+    void updateHotspots();
+
+private:
+    ManagmentSystem&                            ms_;
+    std::mt19937_64                             engine_;
+    std::vector<size_t>                         hotspots_;
+    size_t                                      numVertices_;   // number of vertices when the hotspots were placed
+    bool                                        fixedHotspots_;
+    cmn::tick_t                                 time_;          // ticks passed since the start
+    cmn::tick_t                                 nextArrival_;   // tick of the next candidate arrival
+    double                                      maxRate_;       // orders per hour, bounds the rate of the profile
+};
+
+} // namespace ds
+
+#endif // !GENERATOR_HPP
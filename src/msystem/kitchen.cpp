@@ -7,102 +7,288 @@
 #include"common.hpp"
 #include"kitchen.hpp"
 #include"msystem.hpp"
+#include"options.hpp"
+#include"trace.hpp"
+#include<algorithm>
 #include<assert.h>
+#include<functional>
 
 namespace ds {
 
 using namespace std;
 
+namespace {
+
+// expected pause of the kitchener after each food
+constexpr cmn::tick_t pauseTime{
+    ((100 - Options::pauseChance_) * 5 +
+        Options::pauseChance_ * (Options::minPauseTime_ + Options::maxPauseTime_) / 2) *
+    cmn::ticksPerSecond / 100
+};
+
+// the food trace shows only whether the food is made, this one shows where
+const cmn::TraceCategory stationTrace{
+    u8"station", [](int state) {
+        constexpr string_view names[]{
+            u8"Dough queue", u8"Dough making",
+            u8"Filling queue", u8"Filling making",
+            u8"Picker queue", u8"Picker making"
+        };
+        static_assert(size(names) == cmn::numberOf<KitchenerType>() * 2);
+        return state >= 0 && size_t(state) < size(names) ? names[state] : string_view{ u8"UNKNOWN" };
+    }
+};
+
+} // namespace
+
 Kitchen::Kitchen()
     :
     ms_             { nullptr },
     orders_         {},
+    completed_      {},
     queueDough_     {},
     queueFilling_   {},
     queuePicker_    {},
-    kitcheners_     {}
+    batches_        {},
+    changed_        {},
+    idle_           {},
+    freeTime_       {},
+    arrivals_       {},
+    plan_           {},
+    replanFrom_     { KitchenerType::__INVALID }
 {}
 
 void Kitchen::update(chrono::nanoseconds passedTime)
 {
+    const cmn::TraceSpan span{ u8"Kitchen::update" };
     this->distributeOrders();
-    for (auto& k : kitcheners_) {
-        k->update(passedTime);
-    }
+    this->updateKitcheners(passedTime);
     this->processOrders();
+    this->replan();
+}
+
+void Kitchen::updateKitcheners(chrono::nanoseconds passedTime)
+{
+    // each kitchener is updated once in the batch of its status,
+    // so the kitcheners that changed the status join their new batches afterwards
+    this->updateBatch<&Kitchener::updateInaccessible>(KitchenerStatus::INACCESSIBLE, passedTime);
+    this->updateBatch<&Kitchener::updateWaiting>(KitchenerStatus::WAITING_FOR_NEXT, passedTime);
+    this->updateBatch<&Kitchener::updateMaking>(KitchenerStatus::MAKING, passedTime);
+    static_assert(cmn::numberOf<KitchenerStatus>() == 3);
+    for (Kitchener* kitchener : changed_) {
+        batches_[cmn::toUnderlying(kitchener->getStatus())].push_back(kitchener);
+    }
+    changed_.clear();
+}
+
+template <void (*Update)(Kitchener&, chrono::nanoseconds)>
+void Kitchen::updateBatch(KitchenerStatus status, chrono::nanoseconds passedTime)
+{
+    vector<Kitchener*>& batch{ batches_[cmn::toUnderlying(status)] };
+    for (size_t i = 0; i < batch.size();) {
+        Kitchener* kitchener{ batch[i] };
+        Update(*kitchener, passedTime);
+        if (kitchener->status_ != status) {
+            changed_.push_back(kitchener);
+            batch[i] = batch.back();
+            batch.pop_back();
+        }
+        else {
+            ++i;
+        }
+    }
 }
 
 void Kitchen::distributeOrders()
 {
-    vector<Kitchener*> making;
-    for (auto iter{ kitcheners_.begin() }; iter != kitcheners_.end();) {
-        Kitchener* kitchener{ *iter };
-        if (kitchener->getStatus() == KitchenerStatus::WAITING_FOR_NEXT) {
-            switch (kitchener->getType()) {
-            case KitchenerType::DOUGH:
-                if (!queueDough_.empty()) {
-                    kitchener->makeFood(queueDough_.front());
-                    queueDough_.erase(queueDough_.begin());
-                    iter = kitcheners_.erase(iter);
-                    making.push_back(kitchener);
-                    continue;
-                }
-                break;
-            case KitchenerType::FILLING:
-                if (!queueFilling_.empty()) {
-                    kitchener->makeFood(queueFilling_.front());
-                    queueFilling_.erase(queueFilling_.begin());
-                    iter = kitcheners_.erase(iter);
-                    making.push_back(kitchener);
-                    continue;
-                }
-                break;
-            case KitchenerType::PICKER:
-                if (!queuePicker_.empty()) {
-                    kitchener->makeFood(queuePicker_.front());
-                    queuePicker_.erase(queuePicker_.begin());
-                    iter = kitcheners_.erase(iter);
-                    making.push_back(kitchener);
-                    continue;
-                }
-                break;
-            default:
-                assert(false);
-                break;
-            }
+    for (char t = 0; t < cmn::numberOf<KitchenerType>(); ++t) {
+        vector<Kitchener*>& idle{ idle_[t] };
+        vector<Food*>& queue{ this->getQueue(KitchenerType{ t }) };
+        const size_t n{ min(idle.size(), queue.size()) };
+        if (n > 0) {
+            this->invalidatePlan(KitchenerType{ t });
+        }
+        for (size_t i = 0; i < n; ++i) {
+            Kitchener* kitchener{ idle.back() };
+            idle.pop_back();
+            assert(kitchener->getStatus() == KitchenerStatus::WAITING_FOR_NEXT);
+            kitchener->makeFood(queue[i]);
         }
-        ++iter;
+        queue.erase(queue.begin(), queue.begin() + n);
     }
-    kitcheners_.insert(kitcheners_.end(), making.begin(), making.end());
 }
 
 void Kitchen::processOrders()
 {
     assert(ms_ != nullptr);
-    for (auto iter{ orders_.begin() }; iter != orders_.end();) {
-        Order* order{ *iter };
-        bool orderDone{ true };
-        bool orderCooking{ false };
-        for (const auto& food : order->getFood()) {
-            const FoodStatus status{ food.getStatus() };
-            if (status != FoodStatus::DONE) {
-                orderDone = false;
-                if (status == FoodStatus::MAKING) {
-                    orderCooking = true;
+    for (Order* order : completed_) {
+        orders_.erase(find(orders_.begin(), orders_.end(), order));
+        ms_->processOrder(order);
+    }
+    completed_.clear();
+}
+
+void Kitchen::updateOrder(Food* food, FoodStatus status)
+{
+    assert(food != nullptr);
+    Order* order{ &this->getOrder(food) };
+    order->setFoodStatus(*food, status);
+    if (order->getNumberOfFood(FoodStatus::DONE) == order->getFood().size()) {
+        order->setStatus(OrderStatus::COOKING_COMPLETED);
+        completed_.push_back(order);
+    }
+    else if (order->getNumberOfFood(FoodStatus::MAKING) > 0) {
+        order->setStatus(OrderStatus::COOKING);
+    }
+}
+
+void Kitchen::predictReadyTime(Order* order)
+{
+    // the food is planned through its stations in the order it is queued,
+    // each food of a station is taken by the kitchener that is free first
+    assert(ms_ != nullptr);
+    const cmn::tick_t currentTime{ ms_->getCurrentTick() };
+    cmn::tick_t readyTime{ currentTime };
+    for (const Food& food : order->getFood()) {
+        cmn::tick_t time{ currentTime };
+        switch (food.getType()) {
+        case FoodType::PIZZA:
+            time = this->planStage(KitchenerType::DOUGH, time,
+                getMakingTime(food, KitchenerType::DOUGH));
+            [[fallthrough]];
+        case FoodType::SIDES:
+            time = this->planStage(KitchenerType::FILLING, time,
+                getMakingTime(food, KitchenerType::FILLING));
+            [[fallthrough]];
+        case FoodType::DRINKS:
+            time = this->planStage(KitchenerType::PICKER, time,
+                getMakingTime(food, KitchenerType::PICKER));
+            break;
+        default:
+            assert(false);
+            break;
+        }
+        readyTime = max(readyTime, time);
+    }
+    order->setReadyTime(readyTime);
+}
+
+void Kitchen::recomputePlan()
+{
+    this->invalidatePlan(cmn::firstEnum<KitchenerType>());
+    this->replan();
+}
+
+void Kitchen::replan()
+{
+    // The predicted times drift from the real ones, e.g. the pauses are random,
+    // so a station is planned again from the real state of its kitcheners when a stage
+    // starts or finishes there. The food passes the stations in the order of its arrival
+    // at them, so the stations after it are planned again too, the ones before it keep
+    // their plan and the food planned to come from them.
+    if (replanFrom_ == KitchenerType::__INVALID) {
+        return;
+    }
+    assert(ms_ != nullptr);
+    const cmn::tick_t currentTime{ ms_->getCurrentTick() };
+    for (size_t t = cmn::toUnderlying(replanFrom_); t < cmn::numberOf<KitchenerType>(); ++t) {
+        const KitchenerType type{ static_cast<KitchenerType>(t) };
+        plan_.assign(arrivals_[t].cbegin(), arrivals_[t].cend());
+        for (Food* food : this->getQueue(type)) {
+            plan_.emplace_back(currentTime, food);
+        }
+        sort(plan_.begin(), plan_.end(), [this](const auto& lhs, const auto& rhs) {
+            if (lhs.first != rhs.first) {
+                return lhs.first < rhs.first;
+            }
+            const OrderID lhsID{ this->getOrder(lhs.second).getID() };
+            const OrderID rhsID{ this->getOrder(rhs.second).getID() };
+            return lhsID != rhsID ? lhsID < rhsID : lhs.second < rhs.second;
+        });
+        vector<cmn::tick_t>& freeTime{ freeTime_[t] };
+        freeTime.clear();
+        for (const auto& batch : batches_) {
+            for (const Kitchener* kitchener : batch) {
+                if (kitchener->getType() == type) {
+                    const cmn::tick_t finishTime{ this->getFinishTime(*kitchener, currentTime) };
+                    freeTime.push_back(kitchener->food_ != nullptr ? finishTime + pauseTime : finishTime);
                 }
             }
         }
-        if (orderDone) {
-            iter = orders_.erase(iter);
-            order->setStatus(OrderStatus::COOKING_COMPLETED);
-            ms_->processOrder(order);
+        make_heap(freeTime.begin(), freeTime.end(), greater<cmn::tick_t>{});
+        for (auto& [time, food] : plan_) {
+            time = this->planStage(type, time, getMakingTime(*food, type));
         }
-        else {
-            ++iter;
-            if (orderCooking) {
-                order->setStatus(OrderStatus::COOKING);
+        // the food being made goes on to the next station
+        for (const auto& batch : batches_) {
+            for (const Kitchener* kitchener : batch) {
+                if (kitchener->getType() == type && kitchener->food_ != nullptr) {
+                    plan_.emplace_back(this->getFinishTime(*kitchener, currentTime), kitchener->food_);
+                }
             }
         }
+        if (t + 1 < cmn::numberOf<KitchenerType>()) {
+            arrivals_[t + 1].assign(plan_.cbegin(), plan_.cend());
+        }
+    }
+    // all food passes the last station, so its plan has the ready times of all orders
+    for (Order* order : orders_) {
+        order->setReadyTime(currentTime);
+    }
+    for (const auto& [time, food] : plan_) {
+        Order& order{ this->getOrder(food) };
+        order.setReadyTime(max(order.getReadyTime(), time));
+    }
+    replanFrom_ = KitchenerType::__INVALID;
+}
+
+cmn::tick_t Kitchen::getFinishTime(const Kitchener& kitchener, cmn::tick_t currentTime) const
+{
+    chrono::nanoseconds remainingTime{ 0 };
+    if (kitchener.food_ != nullptr) {
+        remainingTime = kitchener.prevStatus_ == KitchenerStatus::MAKING ?
+            kitchener.makingTime_ - kitchener.passedTime_ : getMakingTime(*kitchener.food_, kitchener.getType());
+    }
+    else if (kitchener.getStatus() == KitchenerStatus::INACCESSIBLE) {
+        if (kitchener.prevStatus_ != KitchenerStatus::INACCESSIBLE) {
+            return currentTime + pauseTime;
+        }
+        remainingTime = kitchener.makingTime_ - kitchener.passedTime_;
+    }
+    return currentTime + cmn::toTicks(max(remainingTime, chrono::nanoseconds{ 0 }));
+}
+
+cmn::tick_t Kitchen::planStage(KitchenerType type, cmn::tick_t arrival,
+    chrono::nanoseconds makingTime)
+{
+    vector<cmn::tick_t>& freeTime{ freeTime_[cmn::toUnderlying(type)] };
+    if (freeTime.empty() || arrival == cmn::maxTick) {
+        return cmn::maxTick;
+    }
+    pop_heap(freeTime.begin(), freeTime.end(), greater<cmn::tick_t>{});
+    const cmn::tick_t readyTime{ max(freeTime.back(), arrival) + cmn::toTicks(makingTime) };
+    freeTime.back() = readyTime + pauseTime;
+    push_heap(freeTime.begin(), freeTime.end(), greater<cmn::tick_t>{});
+    return readyTime;
+}
+
+chrono::nanoseconds Kitchen::getMakingTime(const Food& food, KitchenerType type)
+{
+    // the same times as the kitchener spends in the making status
+    switch (type) {
+    case KitchenerType::DOUGH:
+        return food.getType() == FoodType::PIZZA ? food.doughTime_ : chrono::seconds{ 0 };
+    case KitchenerType::FILLING:
+        if (food.getType() == FoodType::DRINKS) {
+            return chrono::seconds{ 0 };
+        }
+        return food.getType() == FoodType::PIZZA ?
+            food.getPreparationTime() - food.doughTime_ : food.getPreparationTime();
+    case KitchenerType::PICKER:
+        return food.getCookingTime();
+    default:
+        assert(false);
+        return chrono::seconds{ 0 };
     }
 }
 
@@ -114,49 +300,126 @@ void Kitchen::makeOrder(Order* order)
     for (auto& food : order->getFood()) {
         switch (food.getType()) {
         case FoodType::PIZZA:
+            traceStation(&food, -1, getStationState(KitchenerType::DOUGH, false));
             queueDough_.push_back(&food);
+            this->invalidatePlan(KitchenerType::DOUGH);
             break;
         case FoodType::SIDES:
+            traceStation(&food, -1, getStationState(KitchenerType::FILLING, false));
             queueFilling_.push_back(&food);
+            this->invalidatePlan(KitchenerType::FILLING);
             break;
         case FoodType::DRINKS:
+            traceStation(&food, -1, getStationState(KitchenerType::PICKER, false));
             queuePicker_.push_back(&food);
+            this->invalidatePlan(KitchenerType::PICKER);
             break;
         default:
             assert(false);
             break;
         }
     }
+    // any queue can hold all food in the kitchen and the order can be completed at once,
+    // so passing the food between the stages does not allocate
+    size_t numFood{ 0 };
+    for (const Order* o : orders_) {
+        numFood += o->getFood().size();
+    }
+    cmn::reserveGrowing(queueDough_, numFood);
+    cmn::reserveGrowing(queueFilling_, numFood);
+    cmn::reserveGrowing(queuePicker_, numFood);
+    cmn::reserveGrowing(plan_, numFood);
+    for (auto& arrivals : arrivals_) {
+        cmn::reserveGrowing(arrivals, numFood);
+    }
+    cmn::reserveGrowing(completed_, orders_.size());
+    // the order has its ready time at once, the stations are planned again at the end of the update
+    this->predictReadyTime(order);
 }
 
 void Kitchen::addKitchener(Kitchener* kitchener)
 {
     assert(kitchener != nullptr);
-    kitcheners_.push_back(kitchener);
+    batches_[cmn::toUnderlying(kitchener->getStatus())].push_back(kitchener);
+    freeTime_[cmn::toUnderlying(kitchener->getType())].push_back(cmn::tick_t{ 0 });
+    // any batch can hold all kitcheners, so the updates do not allocate
+    size_t numKitcheners{ 0 };
+    for (const auto& batch : batches_) {
+        numKitcheners += batch.size();
+    }
+    for (auto& batch : batches_) {
+        batch.reserve(numKitcheners);
+    }
+    changed_.reserve(numKitcheners);
+    idle_[cmn::toUnderlying(kitchener->getType())].reserve(
+        freeTime_[cmn::toUnderlying(kitchener->getType())].size());
+    if (kitchener->getStatus() == KitchenerStatus::WAITING_FOR_NEXT
+        && kitchener->getFood() == nullptr)
+    {
+        this->pushIdleKitchener(kitchener);
+    }
+    this->invalidatePlan(kitchener->getType());
+    this->replan();
 }
 
 void Kitchen::deleteKitchener(Kitchener* kitchener)
 {
     assert(kitchener != nullptr);
-    for (auto iter{ kitcheners_.begin() }; iter != kitcheners_.end(); ++iter) {
-        if (*iter == kitchener) {
-            kitcheners_.erase(iter);
-            break;
-        }
+    auto& batch{ batches_[cmn::toUnderlying(kitchener->getStatus())] };
+    const auto iterBatch{ find(batch.begin(), batch.end(), kitchener) };
+    if (iterBatch != batch.end()) {
+        batch.erase(iterBatch);
+    }
+    auto& idle{ idle_[cmn::toUnderlying(kitchener->getType())] };
+    const auto iter{ find(idle.begin(), idle.end(), kitchener) };
+    if (iter != idle.end()) {
+        idle.erase(iter);
     }
+    this->invalidatePlan(kitchener->getType());
+    this->replan();
 }
 
-const Order& Kitchen::getOrder(Food* food) const
+void Kitchen::pushIdleKitchener(Kitchener* kitchener)
 {
-    assert(food != nullptr);
-    for (Order* order : orders_) {
-        for (Food& f : order->getFood()) {
-            if (food == &f) {
-                return *order;
-            }
-        }
+    assert(kitchener != nullptr);
+    idle_[cmn::toUnderlying(kitchener->getType())].push_back(kitchener);
+}
+
+vector<Food*>& Kitchen::getQueue(KitchenerType type)
+{
+    switch (type) {
+    case KitchenerType::DOUGH:
+        return queueDough_;
+    case KitchenerType::FILLING:
+        return queueFilling_;
+    case KitchenerType::PICKER:
+        return queuePicker_;
+    default:
+        assert(false);
+        return queueDough_;
     }
-    throw;
+}
+
+size_t Kitchen::getQueueSize(KitchenerType type) const
+{
+    switch (type) {
+    case KitchenerType::DOUGH:
+        return queueDough_.size();
+    case KitchenerType::FILLING:
+        return queueFilling_.size();
+    case KitchenerType::PICKER:
+        return queuePicker_.size();
+    default:
+        assert(false);
+        return 0;
+    }
+}
+
+Order& Kitchen::getOrder(const Food* food) const
+{
+    assert(ms_ != nullptr);
+    assert(food != nullptr && food->getOrderHandle() != Food::noOrder_);
+    return ms_->getOrder(food->getOrderHandle());
 }
 
 void Kitchen::pushFrontQueue(std::vector<Food*>& queue, Food* food)
@@ -172,4 +435,16 @@ void Kitchen::pushFrontQueue(std::vector<Food*>& queue, Food* food)
     queue.insert(iter, food);
 }
 
+void Kitchen::traceStation(const Food* food, int from, int to) const noexcept
+{
+    assert(food != nullptr);
+    cmn::Tracer& tracer{ cmn::Tracer::instance() };
+    if (tracer.isEnabled() && food->getOrderHandle() != Food::noOrder_) {
+        // the same identifier as of the food trace
+        const Order& order{ this->getOrder(food) };
+        const size_t index( food - order.getFood().begin() );
+        tracer.addTransition(stationTrace, cmn::toUnderlying(order.getID()) * Order::maxFood_ + index, from, to);
+    }
+}
+
 } // namespace ds
@@ -7,19 +7,23 @@
 #ifndef KITCHEN_HPP
 #define KITCHEN_HPP
 
+#include"common.hpp"
 #include"kitchener.hpp"
 #include"order.hpp"
+#include<array>
 #include<chrono>
 #include<utility>
 #include<vector>
 
 namespace ds {
 
+class Checkpoint;
 class ManagmentSystem;
 
 class Kitchen {
 public:
-    friend KitchenerMaking;
+    friend Checkpoint;
+    friend Kitchener;
 
 public:
     Kitchen();
@@ -40,7 +44,12 @@ public:
 
     void setManagmentSystem(ManagmentSystem* ms) { ms_ = ms; }
 
-    const Order& getOrder(Food* food) const;
+    Order& getOrder(const Food* food) const;
+
+    size_t getNumberOfOrders() const noexcept { return orders_.size(); }
+
+    // number of food items waiting for the kitcheners of the type
+    size_t getQueueSize(KitchenerType type) const;
 
     auto getOrders() const { return std::pair{ orders_.cbegin(), orders_.cend() }; }
 
@@ -50,26 +59,87 @@ public:
 
     auto getQueuePicker() { return std::pair{ queuePicker_.cbegin(), queuePicker_.cend() }; }
 
+    // plans all stations again from the real state of the kitcheners,
+    // the updates plan again only the stations that changed and the ones after them
+    void recomputePlan();
+
 private:
     void distributeOrders();
 
+    void updateKitcheners(std::chrono::nanoseconds passedTime);
+
+    template <void (*Update)(Kitchener&, std::chrono::nanoseconds)>
+    void updateBatch(KitchenerStatus status, std::chrono::nanoseconds passedTime);
+
     void processOrders();
 
+    // the food of the order changes its status, then the order follows its food
+    void updateOrder(Food* food, FoodStatus status);
+
+    void pushIdleKitchener(Kitchener* kitchener);
+
+    void predictReadyTime(Order* order);
+
+    // the station and the ones after it are planned again at the end of the update
+    void invalidatePlan(KitchenerType type) noexcept
+    {
+        if (replanFrom_ == KitchenerType::__INVALID || type < replanFrom_) {
+            replanFrom_ = type;
+        }
+    }
+
+    // plans the invalidated stations, the ready times of all orders are set from the plan
+    void replan();
+
+    // end of the current food or pause of the kitchener
+    cmn::tick_t getFinishTime(const Kitchener& kitchener, cmn::tick_t currentTime) const;
+
+    cmn::tick_t planStage(KitchenerType type, cmn::tick_t arrival,
+        std::chrono::nanoseconds makingTime);
+
+    static std::chrono::nanoseconds getMakingTime(const Food& food, KitchenerType type);
+
+    std::vector<Food*>& getQueue(KitchenerType type);
+
     void pushFrontQueueDough(Food* food) { pushFrontQueue(queueDough_, food); }
 
-    void pushFrontQueueFilling(Food* food) { pushFrontQueue(queueFilling_, food); }
+    void pushFrontQueueFilling(Food* food)
+    {
+        traceStation(food, getStationState(KitchenerType::DOUGH, true), getStationState(KitchenerType::FILLING, false));
+        pushFrontQueue(queueFilling_, food);
+    }
 
-    void pushFrontQueuePicker(Food* food) { pushFrontQueue(queuePicker_, food); }
+    void pushFrontQueuePicker(Food* food)
+    {
+        traceStation(food, getStationState(KitchenerType::FILLING, true), getStationState(KitchenerType::PICKER, false));
+        pushFrontQueue(queuePicker_, food);
+    }
 
     void pushFrontQueue(std::vector<Food*>& queue, Food* food);
 
+    // the food waits in the queue of the station or is made there
+    static int getStationState(KitchenerType type, bool isMaking) noexcept
+    {
+        return cmn::toUnderlying(type) * 2 + (isMaking ? 1 : 0);
+    }
+
+    // the food goes from the state 'from' to the state 'to' of the stations, a negative state means no station
+    void traceStation(const Food* food, int from, int to) const noexcept;
+
 private:
     ManagmentSystem*                            ms_;
     std::vector<Order*>                         orders_;        // current orders in the kitchen
+    std::vector<Order*>                         completed_;     // orders completed since the last processing
     std::vector<Food*>                          queueDough_;
     std::vector<Food*>                          queueFilling_;
     std::vector<Food*>                          queuePicker_;
-    std::vector<Kitchener*>                     kitcheners_;    // working kitcheners
+    std::array<std::vector<Kitchener*>, cmn::numberOf<KitchenerStatus>()> batches_; // working kitcheners of each status
+    std::vector<Kitchener*>                     changed_;       // kitcheners that changed the status during the update
+    std::array<std::vector<Kitchener*>, cmn::numberOf<KitchenerType>()> idle_; // kitcheners waiting for the next food of each type
+    std::array<std::vector<cmn::tick_t>, cmn::numberOf<KitchenerType>()> freeTime_; // min-heaps of the predicted times when the kitcheners finish the planned food
+    std::array<std::vector<std::pair<cmn::tick_t, Food*>>, cmn::numberOf<KitchenerType>()> arrivals_; // planned food coming to each station from the previous one
+    std::vector<std::pair<cmn::tick_t, Food*>>  plan_;          // buffer of 'replan', the food with its arrival at a station
+    KitchenerType                               replanFrom_;    // first station to plan again, invalid if the plan is valid
 };
 
 } // namespace ds
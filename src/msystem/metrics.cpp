@@ -0,0 +1,188 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"metrics.hpp"
+#include<assert.h>
+#include<cstdio>
+#include<fstream>
+#include<utility>
+
+namespace ds {
+
+using namespace std;
+
+namespace {
+
+constexpr double nanosecondsPerSecond{ 1e9 };
+
+void writeLabel(ostream& os, const char* name, string_view value)
+{
+    os << '{' << name << u8"=\"";
+    for (const char c : value) {
+        if (c == '"' || c == '\\') {
+            os << '\\';
+        }
+        os << c;
+    }
+    os << u8"\"}";
+}
+
+void writeHeader(ostream& os, const char* name, const char* type, const char* help)
+{
+    os << u8"# HELP " << name << ' ' << help << '\n'
+        << u8"# TYPE " << name << ' ' << type << '\n';
+}
+
+// one sample for each value of the enumeration
+template <class Enum, size_t N>
+void writeByEnum(ostream& os, const char* name, const char* label, const char* help,
+                 const array<size_t, N>& values)
+{
+    static_assert(cmn::numberOf<Enum>() == N);
+    writeHeader(os, name, u8"gauge", help);
+    for (size_t i = 0; i < N; ++i) {
+        os << name;
+        writeLabel(os, label, toString(static_cast<Enum>(i)));
+        os << ' ' << values[i] << '\n';
+    }
+}
+
+} // namespace
+
+void takeMetrics(const ManagmentSystem& ms, Metrics& metrics)
+{
+    metrics.tick_ = ms.getCurrentTick();
+    for (char t = 0; t < cmn::numberOf<KitchenerType>(); ++t) {
+        metrics.queue_[size_t(t)] = ms.kitchen().getQueueSize(static_cast<KitchenerType>(t));
+    }
+    for (char s = 0; s < cmn::numberOf<CourierStatus>(); ++s) {
+        metrics.couriers_[size_t(s)] = ms.delivery().getNumberOfCouriers(static_cast<CourierStatus>(s));
+    }
+    for (char s = 0; s < cmn::numberOf<OrderStatus>(); ++s) {
+        metrics.orders_[size_t(s)] = ms.orderTable().countStatus(static_cast<OrderStatus>(s));
+    }
+    metrics.searches_ = ms.map().getNumberOfSearches();
+    metrics.searchTime_ = ms.map().getSearchTime();
+    metrics.updates_ = ms.getNumberOfUpdates();
+    metrics.updateTime_ = ms.getUpdateTime().count();
+    metrics.lastUpdateTime_ = ms.getLastUpdateTime().count();
+}
+
+void writeMetrics(ostream& os, const Metrics& metrics)
+{
+    writeHeader(os, u8"pizza_ds_simulation_seconds", u8"gauge", u8"Time of the simulation.");
+    os << u8"pizza_ds_simulation_seconds " << double(metrics.tick_) / cmn::ticksPerSecond << '\n';
+
+    writeByEnum<KitchenerType>(os, u8"pizza_ds_queue_length", u8"station",
+                               u8"Food items waiting for the kitcheners of the station.", metrics.queue_);
+    writeByEnum<CourierStatus>(os, u8"pizza_ds_couriers", u8"status",
+                               u8"Working couriers in the status.", metrics.couriers_);
+    writeByEnum<OrderStatus>(os, u8"pizza_ds_orders", u8"status",
+                             u8"Orders in the status.", metrics.orders_);
+
+    writeHeader(os, u8"pizza_ds_route_search_seconds", u8"summary", u8"Wall time of the path searches on the map.");
+    os << u8"pizza_ds_route_search_seconds_sum " << metrics.searchTime_ / nanosecondsPerSecond << '\n'
+        << u8"pizza_ds_route_search_seconds_count " << metrics.searches_ << '\n';
+
+    writeHeader(os, u8"pizza_ds_tick_seconds", u8"summary", u8"Wall time of the updates of the simulation.");
+    os << u8"pizza_ds_tick_seconds_sum " << metrics.updateTime_ / nanosecondsPerSecond << '\n'
+        << u8"pizza_ds_tick_seconds_count " << metrics.updates_ << '\n';
+
+    writeHeader(os, u8"pizza_ds_last_tick_seconds", u8"gauge", u8"Wall time of the last update of the simulation.");
+    os << u8"pizza_ds_last_tick_seconds " << metrics.lastUpdateTime_ / nanosecondsPerSecond << '\n';
+}
+
+///************************************************************************************************
+
+MetricsExporter::MetricsExporter(ManagmentSystem& ms, string fileName, chrono::milliseconds period)
+    :
+    ms_             { ms },
+    fileName_       { std::move(fileName) },
+    period_         { period },
+    snapshots_      {},
+    lastPublish_    {},
+    worker_         {},
+    mutex_          {},
+    wakeUp_         {},
+    writes_         { 0 },
+    stop_           { false }
+{
+    assert(fileName_.empty() == false);
+    assert(minPeriod_ <= period_ && period_ <= maxPeriod_);
+    ms.setTimed(true);
+    worker_ = thread{ &MetricsExporter::work, this };
+}
+
+MetricsExporter::~MetricsExporter() noexcept
+{
+    {
+        lock_guard<mutex> lock{ mutex_ };
+        stop_ = true;
+    }
+    wakeUp_.notify_one();
+    worker_.join();
+}
+
+void MetricsExporter::update() noexcept
+{
+    // the end of the timed update is used instead of reading the clock once more
+    if (ms_.getLastUpdateEnd() - lastPublish_ >= period_) {
+        this->publish();
+    }
+}
+
+void MetricsExporter::publish() noexcept
+{
+    takeMetrics(ms_, snapshots_.getBack());
+    snapshots_.publish();
+    lastPublish_ = ms_.getLastUpdateEnd();
+}
+
+unsigned long long int MetricsExporter::getNumberOfWrites() const noexcept
+{
+    lock_guard<mutex> lock{ mutex_ };
+    return writes_;
+}
+
+void MetricsExporter::work()
+{
+    bool stop{ false };
+    while (stop == false) {
+        {
+            unique_lock<mutex> lock{ mutex_ };
+            wakeUp_.wait_for(lock, period_, [this] { return stop_; });
+            stop = stop_;
+        }
+        // the simulation is not waited for, the snapshot is written if there is a new one
+        if (snapshots_.update() && this->write(snapshots_.getFront())) {
+            lock_guard<mutex> lock{ mutex_ };
+            ++writes_;
+        }
+    }
+}
+
+bool MetricsExporter::write(const Metrics& metrics) const
+{
+    // the readers of the file never see it partially written
+    const string tmpFileName{ fileName_ + u8".tmp" };
+    {
+        ofstream file{ tmpFileName };
+        if (file.is_open() == false) {
+            return false;
+        }
+        writeMetrics(file, metrics);
+        if (file.good() == false) {
+            return false;
+        }
+    }
+    if (rename(tmpFileName.c_str(), fileName_.c_str()) != 0) {
+        // the existing file is not replaced on Windows
+        remove(fileName_.c_str());
+        return rename(tmpFileName.c_str(), fileName_.c_str()) == 0;
+    }
+    return true;
+}
+
+} // namespace ds
@@ -0,0 +1,98 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include"common.hpp"
+#include"courier.hpp"
+#include"kitchener.hpp"
+#include"msystem.hpp"
+#include"order.hpp"
+#include"triple_buffer.hpp"
+#include<array>
+#include<chrono>
+#include<condition_variable>
+#include<mutex>
+#include<ostream>
+#include<string>
+#include<thread>
+
+namespace ds {
+
+// Snapshot of the managment system, it is plain data, so taking it does not allocate
+struct Metrics {
+    cmn::tick_t                                 tick_;
+    std::array<size_t, cmn::numberOf<KitchenerType>()> queue_;  // food items waiting for each station
+    std::array<size_t, cmn::numberOf<CourierStatus>()> couriers_;
+    std::array<size_t, cmn::numberOf<OrderStatus>()> orders_;
+    unsigned long long int                      searches_;      // path searches on the map
+    long long int                               searchTime_;    // nanoseconds
+    unsigned long long int                      updates_;
+    long long int                               updateTime_;    // nanoseconds
+    long long int                               lastUpdateTime_; // nanoseconds
+};
+
+void takeMetrics(const ManagmentSystem& ms, Metrics& metrics);
+
+// Prometheus text exposition format
+void writeMetrics(std::ostream& os, const Metrics& metrics);
+
+///************************************************************************************************
+
+// Exporter of the metrics to a file in the Prometheus text format. The simulation thread only
+// fills a snapshot once per period and passes it through a triple buffer, the file is written
+// on the exporter's own thread, so the simulation never waits for it.
+// The file is replaced atomically, it suits the textfile collector of the node exporter.
+class MetricsExporter {
+public:
+    static constexpr std::chrono::milliseconds defPeriod_{ 1000 };
+    static constexpr std::chrono::milliseconds minPeriod_{ 1 };
+    static constexpr std::chrono::milliseconds maxPeriod_{ 60000 };
+
+public:
+    // the updates of the managment system become timed
+    MetricsExporter(ManagmentSystem& ms, std::string fileName, std::chrono::milliseconds period = defPeriod_);
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // the last published snapshot is written before the return
+    virtual ~MetricsExporter() noexcept;
+
+public:
+    // must be called on the simulation thread after the update of the managment system
+    void update() noexcept;
+
+    // the snapshot is taken regardless of the period
+    void publish() noexcept;
+
+    const std::string& getFileName() const noexcept { return fileName_; }
+
+    // number of the written files, it is read on the simulation thread only approximately
+    unsigned long long int getNumberOfWrites() const noexcept;
+
+private:
+    void work();
+
+    bool write(const Metrics& metrics) const;
+
+private:
+    const ManagmentSystem&                      ms_;
+    const std::string                           fileName_;
+    const std::chrono::milliseconds             period_;
+    cmn::TripleBuffer<Metrics>                  snapshots_;
+    std::chrono::steady_clock::time_point       lastPublish_;   // on the simulation thread
+
+    std::thread                                 worker_;
+    mutable std::mutex                          mutex_;
+    std::condition_variable                     wakeUp_;
+    unsigned long long int                      writes_;
+    bool                                        stop_;
+};
+
+} // namespace ds
+
+#endif // !METRICS_HPP
@@ -5,7 +5,10 @@
 // (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
 
 #include"common.hpp"
+#include"eventlog.hpp"
 #include"msystem.hpp"
+#include"trace.hpp"
+#include<algorithm>
 #include<assert.h>
 #include<utility>
 
@@ -13,46 +16,143 @@ namespace ds {
 
 using namespace std;
 
-ManagmentSystem::ManagmentSystem(Map& map, Scheduler& scheduler, Kitchen& kitchen, Delivery& delivery)
+string_view toString(OrderOrigin value) noexcept
+{
+    switch (value) {
+    case OrderOrigin::__INVALID:
+        return u8"INVALID";
+    case OrderOrigin::DIRECT:
+        return u8"Direct";
+    case OrderOrigin::RANDOM:
+        return u8"Random";
+    case OrderOrigin::INTAKE:
+        return u8"Intake";
+    default:
+        return u8"UNKNOWN";
+    }
+    static_assert(cmn::numberOf<OrderOrigin>() == 3);
+}
+
+///************************************************************************************************
+
+ManagmentSystem::ManagmentSystem(Map& map, Scheduler& scheduler, Kitchen& kitchen, Delivery& delivery,
+                                 const OptionsSimulation& options)
     :
     map_                { map },
     scheduler_          { scheduler },
     kitchen_            { kitchen },
     delivery_           { delivery },
+    orderTable_         {},
+    paths_              { map },
+    options_            { options },
+    nextOptions_        {},
     orders_             {},
     couriers_           {},
     kitcheners_         {},
     startTime_          { chrono::system_clock::now() },
-    passedTime_         { 0 },
-    nextOrderID_        { 0 }
+    currentTick_        { 0 },
+    nextOrderID_        { 0 },
+    orderIDStep_        { 1 },
+    intake_             { intakeCapacity_ },
+    eventLog_           { nullptr },
+    allocations_        { 0 },
+    updates_            { 0 },
+    updateTime_         { 0 },
+    lastUpdateTime_     { 0 },
+    lastUpdateEnd_      {},
+    isTimed_            { false }
 {}
 
 void ManagmentSystem::update(chrono::nanoseconds passedTime)
 {
-    passedTime_ += passedTime;
+    const auto begin{ isTimed_ ? chrono::steady_clock::now() : chrono::steady_clock::time_point{} };
+    const unsigned long long int allocations{ cmn::getAllocationCount() };
+    if (nextOptions_.update()) {
+        options_ = nextOptions_.getFront();
+    }
+    if (eventLog_ != nullptr) {
+        eventLog_->addUpdate(*this, passedTime);
+    }
+    currentTick_ += cmn::toTicks(passedTime);
+    orderTable_.setCurrentTick(currentTick_);
+    cmn::Tracer::instance().setTick(currentTick_);
+    this->drainIntake();
     kitchen_.update(passedTime);
     delivery_.update(passedTime);
+    allocations_ = cmn::getAllocationCount() - allocations;
+    ++updates_;
+    if (isTimed_) {
+        lastUpdateEnd_ = chrono::steady_clock::now();
+        lastUpdateTime_ = lastUpdateEnd_ - begin;
+        updateTime_ += lastUpdateTime_;
+    }
 }
 
 Order* ManagmentSystem::createOrder()
 {
     int randomTarget{ cmn::getRandomNumber(1, map_.graph().m_vertices.size() - 1) };
     assert(randomTarget >= 0);
-    unique_ptr<Order> order{ new Order{ nextOrderID_, size_t(randomTarget), getCurrentTime() } };
+    return createOrder(size_t(randomTarget), OrderOrigin::RANDOM, currentTick_);
+}
+
+Order* ManagmentSystem::createOrder(size_t target)
+{
+    return createOrder(target, OrderOrigin::DIRECT, currentTick_);
+}
+
+Order* ManagmentSystem::createOrder(size_t target, cmn::tick_t arrivalTick)
+{
+    return createOrder(target, OrderOrigin::DIRECT, max(arrivalTick, currentTick_));
+}
+
+void ManagmentSystem::setEventLog(EventLog* eventLog)
+{
+    // the recorded seed must precede all uses of the random numbers
+    assert(eventLog == nullptr || (orders_.empty() && couriers_.empty() && kitcheners_.empty()));
+    eventLog_ = eventLog;
+    if (eventLog_ != nullptr) {
+        eventLog_->start(*this);
+    }
+}
+
+Order* ManagmentSystem::createOrder(size_t target, OrderOrigin origin, cmn::tick_t arrivalTick)
+{
+    assert(target < map_.graph().m_vertices.size());
+    if (eventLog_ != nullptr) {
+        // the edits made since the last event are applied before the order in a replay
+        eventLog_->addChanges(*this);
+    }
+    const OrderHandle handle{ orderTable_.addOrder(nextOrderID_, target, arrivalTick) };
+    assert(static_cast<size_t>(handle) == orders_.size());
+    unique_ptr<Order> order{ new Order{ orderTable_, handle } };
     assert(order.get() != nullptr);
-    nextOrderID_ = OrderID{ cmn::toUnderlying(nextOrderID_) + 1 };
+    nextOrderID_ = OrderID{ cmn::toUnderlying(nextOrderID_) + orderIDStep_ };
     order->setStatus(OrderStatus::ACCEPTED);
     order->isPaid(cmn::getRandomNumber(0, 1));
     order->setFood(createRandomFood());
     orders_.push_back(std::move(order));
     Order* o{ orders_.back().get() };
+    if (eventLog_ != nullptr) {
+        eventLog_->addOrder(*this, *o, origin);
+    }
     scheduler_.processOrder(o);
     return o;
 }
 
-ManagmentSystem::time_point_t ManagmentSystem::getCurrentTime() const noexcept
+void ManagmentSystem::drainIntake()
+{
+    // at most a full queue of requests is taken, so a fast producer can not hold the update
+    OrderRequest request{};
+    for (size_t i = 0; i < intakeCapacity_ && intake_.pop(request); ++i) {
+        if (request.target_ < map_.graph().m_vertices.size()) {
+            createOrder(request.target_, OrderOrigin::INTAKE, currentTick_);
+        }
+    }
+}
+
+ManagmentSystem::time_point_t ManagmentSystem::getTime(cmn::tick_t tick) const noexcept
 {
-    return startTime_ + chrono::duration_cast<time_point_t::duration>(passedTime_);
+    return startTime_ + chrono::duration_cast<time_point_t::duration>(cmn::toDuration(tick));
 }
 
 Courier* ManagmentSystem::activateCourier(WorkerID workerID)
@@ -62,6 +162,9 @@ Courier* ManagmentSystem::activateCourier(WorkerID workerID)
             return nullptr;
         }
     }
+    if (eventLog_ != nullptr) {
+        eventLog_->addCourier(*this, workerID, true);
+    }
     unique_ptr<Courier> newCourier{ new Courier{ *this, workerID } };
     couriers_.push_back(std::move(newCourier));
     Courier* c{ couriers_.back().get() };
@@ -73,6 +176,9 @@ bool ManagmentSystem::deactivateCourier(WorkerID workerID)
 {
     for (auto iter{ couriers_.begin() }; iter != couriers_.end(); ++iter) {
         if (iter->get()->getID() == workerID) {
+            if (eventLog_ != nullptr) {
+                eventLog_->addCourier(*this, workerID, false);
+            }
             delivery_.deleteCourier(iter->get());
             couriers_.erase(iter);
             return true;
@@ -88,6 +194,9 @@ Kitchener* ManagmentSystem::activateKitchener(WorkerID workerID, KitchenerType t
             return nullptr;
         }
     }
+    if (eventLog_ != nullptr) {
+        eventLog_->addKitchener(*this, workerID, type, true);
+    }
     unique_ptr<Kitchener> newKitchener{ new Kitchener{ *this, workerID, type } };
     kitcheners_.push_back(std::move(newKitchener));
     Kitchener* k{ kitcheners_.back().get() };
@@ -99,6 +208,9 @@ bool ManagmentSystem::deactivateKitchener(WorkerID workerID)
 {
     for (auto iter{ kitcheners_.begin() }; iter != kitcheners_.end(); ++iter) {
         if (iter->get()->getID() == workerID) {
+            if (eventLog_ != nullptr) {
+                eventLog_->addKitchener(*this, workerID, iter->get()->getType(), false);
+            }
             kitchen_.deleteKitchener(iter->get());
             kitcheners_.erase(iter);
             return true;
@@ -109,10 +221,10 @@ bool ManagmentSystem::deactivateKitchener(WorkerID workerID)
 
 ///************************************************************************************************
 
-vector<Food> createRandomFood()
+Order::food_list_t createRandomFood()
 {
-    vector<Food> food;
-    int n{ cmn::getRandomNumber(1, 6) };
+    Order::food_list_t food;
+    int n{ cmn::getRandomNumber(1, int(Order::maxFood_)) };
     for (int i = 0; i < n; ++i) {
         FoodName name{ char(cmn::getRandomNumber(
             cmn::toUnderlying(cmn::firstEnum<FoodName>()),
@@ -127,7 +239,6 @@ vector<Food> createRandomFood()
         }
         if (isExist == false) {
             food.push_back(Food{ unsigned short(cmn::getRandomNumber(1, 3)), name });
-            food.back().setStatus(FoodStatus::WAITING_FOR_MAKING);
         }
     }
     return food;
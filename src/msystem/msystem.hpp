@@ -7,25 +7,63 @@
 #ifndef MANAGMENT_SYSTEM_HPP
 #define MANAGMENT_SYSTEM_HPP
 
+#include"allocation.hpp"
+#include"common.hpp"
 #include"courier.hpp"
 #include"delivery.hpp"
 #include"kitchen.hpp"
 #include"map.hpp"
+#include"options.hpp"
 #include"order.hpp"
+#include"queue.hpp"
 #include"scheduler.hpp"
+#include"triple_buffer.hpp"
+#include<assert.h>
 #include<chrono>
 #include<memory>
+#include<string_view>
 #include<utility>
 #include<vector>
 
 namespace ds {
 
+// request to create an order, it can be submitted from any thread
+struct OrderRequest {
+    size_t                                      target_;
+};
+
+// the way the order was created, a replay creates it the same way
+enum class OrderOrigin : char {
+    __INVALID = -1,                 /// invalid, must be the first
+    // vvv ORIGINS vvv
+    DIRECT,                         /// the target is given
+    RANDOM,                         /// the target is random
+    INTAKE,                         /// the request is taken at the start of an update
+    // ^^^ ORIGINS ^^^
+    __NUMBER_OF,
+    __END                           /// must be the last
+};
+
+std::string_view toString(OrderOrigin value) noexcept;
+
+class Checkpoint;
+class EventLog;
+
+///************************************************************************************************
+
 class ManagmentSystem {
+public:
+    friend Checkpoint;
+
+public:
+    static constexpr size_t intakeCapacity_{ 1 << 12 };     // maximum number of pending order requests
+
 public:
     using time_point_t = std::chrono::system_clock::time_point;
 
 public:
-    ManagmentSystem(Map& map, Scheduler& scheduler, Kitchen& kitchen, Delivery& delivery);
+    ManagmentSystem(Map& map, Scheduler& scheduler, Kitchen& kitchen, Delivery& delivery,
+                    const OptionsSimulation& options);
 
     ManagmentSystem(const ManagmentSystem&) = delete;
     ManagmentSystem& operator=(const ManagmentSystem&) = delete;
@@ -51,17 +89,73 @@ public:
 
     Delivery& delivery() noexcept { return delivery_; }
 
+    const OrderTable& orderTable() const noexcept { return orderTable_; }
+
+    // paths between the vertices of the map, found once for this system
+    MapPathCache& paths() noexcept { return paths_; }
+
+    // the options of this system, they do not change during an update
+    const OptionsSimulation& options() const noexcept { return options_; }
+
+    // can be called from one thread only, e.g. the thread of the GUI, while another thread
+    // updates the system; the options are taken at the start of the next update
+    void setOptions(const OptionsSimulation& options) noexcept;
+
 public:
     Order* createOrder();
 
+    Order* createOrder(size_t target);
+
+    // the order arrived at the tick, e.g. between the current update and the next one,
+    // the orders are not stamped before the current tick
+    Order* createOrder(size_t target, cmn::tick_t arrivalTick);
+
+    // can be called from any thread, the order is created at the start of the next update;
+    // returns false if too many requests are pending
+    bool submitOrder(OrderRequest request) { return intake_.push(request); }
+
+    void setOrderIDs(OrderID first, unsigned int step) noexcept;
+
+    // the inputs of the system are recorded to the log, nullptr stops the recording;
+    // the recording starts before the first worker and the first order
+    void setEventLog(EventLog* eventLog);
+
     void processOrder(Order* order) { scheduler_.processOrder(order); }
 
-    time_point_t getCurrentTime() const noexcept;
+    cmn::tick_t getCurrentTick() const noexcept { return currentTick_; }
+
+    // wall-clock time of the tick, only for the presentation
+    time_point_t getTime(cmn::tick_t tick) const noexcept;
+
+    time_point_t getCurrentTime() const noexcept { return getTime(currentTick_); }
 
     void setCurrentTime() noexcept;
 
+    // global allocations during the last update, only in the builds that count them
+    unsigned long long int getAllocations() const noexcept { return allocations_; }
+
+    // the updates are timed on the wall clock only on demand, the clock is read twice per update
+    void setTimed(bool isTimed) noexcept { isTimed_ = isTimed; }
+
+    unsigned long long int getNumberOfUpdates() const noexcept { return updates_; }
+
+    // total wall time of the timed updates
+    std::chrono::nanoseconds getUpdateTime() const noexcept { return updateTime_; }
+
+    std::chrono::nanoseconds getLastUpdateTime() const noexcept { return lastUpdateTime_; }
+
+    // the end of the last timed update
+    std::chrono::steady_clock::time_point getLastUpdateEnd() const noexcept { return lastUpdateEnd_; }
+
     auto getOrders() const { return std::pair{ orders_.cbegin(), orders_.cend() }; }
 
+    // the handle of an order is its position in the orders
+    Order& getOrder(OrderHandle handle) const
+    {
+        assert(static_cast<size_t>(handle) < orders_.size());
+        return *orders_[static_cast<size_t>(handle)];
+    }
+
     //auto getOrders() { return std::pair{ orders_.begin(), orders_.end() }; }
 
     auto getCouriers() const { return std::pair{ couriers_.cbegin(), couriers_.cend() }; }
@@ -80,30 +174,61 @@ public:
 
     bool deactivateKitchener(WorkerID workerID);
 
+private:
+    Order* createOrder(size_t target, OrderOrigin origin, cmn::tick_t arrivalTick);
+
+    void drainIntake();
+
 private:
     Map&                                        map_;
     Scheduler&                                  scheduler_;
     Kitchen&                                    kitchen_;
     Delivery&                                   delivery_;
+    OrderTable                                  orderTable_;    // data of 'orders_'
+    MapPathCache                                paths_;
+    OptionsSimulation                           options_;
+    cmn::TripleBuffer<OptionsSimulation>        nextOptions_;   // set by 'setOptions', not taken yet
     std::vector<std::unique_ptr<Order>>         orders_;
     std::vector<std::unique_ptr<Courier>>       couriers_;
     std::vector<std::unique_ptr<Kitchener>>     kitcheners_;
-    time_point_t                                startTime_;     // program start time
-    std::chrono::nanoseconds                    passedTime_;    // time passed since startTime_
+    time_point_t                                startTime_;     // wall-clock time of the tick 0
+    cmn::tick_t                                 currentTick_;   // ticks passed since the start
     OrderID                                     nextOrderID_;
+    unsigned int                                orderIDStep_;   // several systems can share the ID space
+    cmn::MPSCQueue<OrderRequest>                intake_;        // order requests from other threads
+    EventLog*                                   eventLog_;
+    unsigned long long int                      allocations_;   // global allocations during the last update
+    unsigned long long int                      updates_;
+    std::chrono::nanoseconds                    updateTime_;    // wall time of the timed updates
+    std::chrono::nanoseconds                    lastUpdateTime_;
+    std::chrono::steady_clock::time_point       lastUpdateEnd_;
+    bool                                        isTimed_;
 };
 
 ///************************************************************************************************
 
 inline void ManagmentSystem::setCurrentTime() noexcept
 {
-    passedTime_ = std::chrono::nanoseconds{ 0 };
+    currentTick_ = 0;
     startTime_ = std::chrono::system_clock::now();
 }
 
+inline void ManagmentSystem::setOptions(const OptionsSimulation& options) noexcept
+{
+    nextOptions_.getBack() = options;
+    nextOptions_.publish();
+}
+
+inline void ManagmentSystem::setOrderIDs(OrderID first, unsigned int step) noexcept
+{
+    assert(step > 0);
+    nextOrderID_ = first;
+    orderIDStep_ = step;
+}
+
 ///************************************************************************************************
 
-std::vector<Food> createRandomFood();
+Order::food_list_t createRandomFood();
 
 } // namespace ds
 
@@ -0,0 +1,249 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"common.hpp"
+#include"network.hpp"
+#include<assert.h>
+#include<boost/graph/dijkstra_shortest_paths.hpp>
+#include<limits>
+#include<utility>
+
+namespace ds {
+
+using namespace std;
+
+string_view toString(OfficeSelection value) noexcept
+{
+    switch (value) {
+    case OfficeSelection::__INVALID:
+        return u8"INVALID";
+    case OfficeSelection::NEAREST:
+        return u8"Nearest";
+    case OfficeSelection::LEAST_LOADED:
+        return u8"Least loaded";
+    default:
+        return u8"UNKNOWN";
+    }
+    static_assert(cmn::numberOf<OfficeSelection>() == 2);
+}
+
+///************************************************************************************************
+
+Office::Office(Map& map, Graph::vertex_descriptor office, const OptionsSimulation& options)
+    :
+    scheduler_      { office },
+    kitchen_        {},
+    delivery_       {},
+    ms_             { map, scheduler_, kitchen_, delivery_, options }
+{
+    scheduler_.setManagmentSystem(&ms_);
+    kitchen_.setManagmentSystem(&ms_);
+    delivery_.setManagmentSystem(&ms_);
+}
+
+///************************************************************************************************
+
+OfficeNetwork::OfficeNetwork(Map& map, const vector<Graph::vertex_descriptor>& offices,
+                             const OptionsSimulation& options)
+    :
+    map_            { map },
+    offices_        {},
+    travelTime_     {},
+    version_        { 0 },
+    selection_      { OfficeSelection::NEAREST },
+    workers_        {},
+    mutex_          {},
+    start_          {},
+    done_           {},
+    exception_      {},
+    passedTime_     { 0 },
+    generation_     { 0 },
+    pending_        { 0 },
+    stop_           { false }
+{
+    assert(offices.empty() == false);
+    offices_.reserve(offices.size());
+    for (size_t i = 0; i < offices.size(); ++i) {
+        offices_.push_back(make_unique<Office>(map_, offices[i], options));
+        offices_.back()->ms_.setOrderIDs(OrderID{ i }, static_cast<unsigned int>(offices.size()));
+    }
+    workers_.reserve(offices_.size() - 1);
+    for (size_t i = 1; i < offices_.size(); ++i) {
+        workers_.emplace_back(&OfficeNetwork::work, this, i);
+    }
+}
+
+OfficeNetwork::~OfficeNetwork() noexcept
+{
+    {
+        lock_guard<mutex> lock{ mutex_ };
+        stop_ = true;
+    }
+    start_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void OfficeNetwork::setOptions(const OptionsSimulation& options) noexcept
+{
+    for (auto& office : offices_) {
+        office->ms_.setOptions(options);
+    }
+}
+
+void OfficeNetwork::update(chrono::nanoseconds passedTime)
+{
+    {
+        lock_guard<mutex> lock{ mutex_ };
+        passedTime_ = passedTime;
+        pending_ = workers_.size();
+        ++generation_;
+    }
+    start_.notify_all();
+    exception_ptr exception{};
+    try {
+        offices_[0]->ms_.update(passedTime);
+    }
+    catch (...) {
+        exception = current_exception();
+    }
+    unique_lock<mutex> lock{ mutex_ };
+    done_.wait(lock, [this] { return pending_ == 0; });
+    if (exception == nullptr) {
+        exception = std::move(exception_);
+    }
+    exception_ = nullptr;
+    if (exception != nullptr) {
+        rethrow_exception(exception);
+    }
+}
+
+void OfficeNetwork::work(size_t index)
+{
+    unsigned long long int generation{ 0 };
+    while (true) {
+        chrono::nanoseconds passedTime{ 0 };
+        {
+            unique_lock<mutex> lock{ mutex_ };
+            start_.wait(lock, [&] { return stop_ || generation_ != generation; });
+            if (stop_) {
+                return;
+            }
+            generation = generation_;
+            passedTime = passedTime_;
+        }
+        exception_ptr exception{};
+        try {
+            offices_[index]->ms_.update(passedTime);
+        }
+        catch (...) {
+            exception = current_exception();
+        }
+        lock_guard<mutex> lock{ mutex_ };
+        if (exception != nullptr && exception_ == nullptr) {
+            exception_ = std::move(exception);
+        }
+        if (--pending_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
+
+Order* OfficeNetwork::createOrder()
+{
+    // the target of an order is never an office
+    size_t target{ 0 };
+    do {
+        int randomTarget{ cmn::getRandomNumber(0, map_.graph().m_vertices.size() - 1) };
+        assert(randomTarget >= 0);
+        target = size_t(randomTarget);
+    } while (isOffice(target));
+    return createOrder(target);
+}
+
+Order* OfficeNetwork::createOrder(size_t target)
+{
+    return offices_[selectOffice(target)]->ms_.createOrder(target);
+}
+
+size_t OfficeNetwork::selectOffice(size_t target)
+{
+    assert(target < map_.graph().m_vertices.size());
+    assert(isOffice(target) == false);
+    size_t selected{ 0 };
+    switch (selection_) {
+    case OfficeSelection::NEAREST: {
+        calculateTravelTime();
+        for (size_t i = 1; i < offices_.size(); ++i) {
+            if (travelTime_[i][target] < travelTime_[selected][target]) {
+                selected = i;
+            }
+        }
+        break;
+    }
+    case OfficeSelection::LEAST_LOADED: {
+        size_t minLoad{ getLoad(0) };
+        for (size_t i = 1; i < offices_.size(); ++i) {
+            const size_t load{ getLoad(i) };
+            if (load < minLoad) {
+                minLoad = load;
+                selected = i;
+            }
+        }
+        break;
+    }
+    default:
+        assert(false);
+        break;
+    }
+    return selected;
+}
+
+bool OfficeNetwork::isOffice(size_t vertex) const
+{
+    for (const auto& office : offices_) {
+        if (office->scheduler_.getOffice() == vertex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void OfficeNetwork::setCurrentTime() noexcept
+{
+    for (auto& office : offices_) {
+        office->ms_.setCurrentTime();
+    }
+}
+
+void OfficeNetwork::calculateTravelTime()
+{
+    // any edit of the map, e.g. a new distance of an edge, changes its version
+    if (travelTime_.size() == offices_.size() && version_ == map_.getVersion()) {
+        return;
+    }
+    const Graph& graph{ map_.graph() };
+    const size_t numVertices{ boost::num_vertices(graph) };
+    travelTime_.resize(offices_.size());
+    for (size_t i = 0; i < offices_.size(); ++i) {
+        travelTime_[i].assign(numVertices, numeric_limits<int>::max());
+        boost::dijkstra_shortest_paths(graph, offices_[i]->scheduler_.getOffice(),
+            boost::weight_map(get(&GraphEdgePropertyMap::time_, graph))
+            .distance_map(boost::make_iterator_property_map(
+                travelTime_[i].begin(), get(boost::vertex_index, graph))));
+    }
+    version_ = map_.getVersion();
+}
+
+size_t OfficeNetwork::getLoad(size_t index) const
+{
+    const auto kitchenOrders{ offices_[index]->kitchen_.getOrders() };
+    const auto deliveryOrders{ offices_[index]->delivery_.getOrders() };
+    return size_t(kitchenOrders.second - kitchenOrders.first)
+        + size_t(deliveryOrders.second - deliveryOrders.first);
+}
+
+} // namespace ds
@@ -0,0 +1,122 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef NETWORK_HPP
+#define NETWORK_HPP
+
+#include"delivery.hpp"
+#include"kitchen.hpp"
+#include"map.hpp"
+#include"msystem.hpp"
+#include"options.hpp"
+#include"order.hpp"
+#include"scheduler.hpp"
+#include<chrono>
+#include<condition_variable>
+#include<exception>
+#include<memory>
+#include<mutex>
+#include<string_view>
+#include<thread>
+#include<vector>
+
+namespace ds {
+
+enum class OfficeSelection : char {
+    __INVALID = -1,                 /// invalid, must be the first
+    // vvv SELECTIONS vvv
+    NEAREST,
+    LEAST_LOADED,
+    // ^^^ SELECTIONS ^^^
+    __NUMBER_OF,
+    __END                           /// must be the last
+};
+
+std::string_view toString(OfficeSelection value) noexcept;
+
+///************************************************************************************************
+
+// Office of the network, the shard with its own scheduler, kitchen and delivery
+struct Office {
+    Office(Map& map, Graph::vertex_descriptor office, const OptionsSimulation& options);
+
+    Office(const Office&) = delete;
+    Office& operator=(const Office&) = delete;
+
+    Scheduler                                   scheduler_;
+    Kitchen                                     kitchen_;
+    Delivery                                    delivery_;
+    ManagmentSystem                             ms_;
+};
+
+///************************************************************************************************
+
+// Several offices over the shared map, each office is updated on its own thread;
+// it is run by pizza-ds-network-bench and the tests, the GUI shows a single office
+class OfficeNetwork {
+public:
+    OfficeNetwork(Map& map, const std::vector<Graph::vertex_descriptor>& offices,
+                  const OptionsSimulation& options);
+
+    OfficeNetwork(const OfficeNetwork&) = delete;
+    OfficeNetwork& operator=(const OfficeNetwork&) = delete;
+
+    virtual ~OfficeNetwork() noexcept;
+
+public:
+    // the options of all offices, taken by every office at the start of its next update;
+    // must be called from one thread only, e.g. the thread of the GUI
+    void setOptions(const OptionsSimulation& options) noexcept;
+
+    void update(std::chrono::nanoseconds passedTime);
+
+    size_t getNumberOfOffices() const noexcept { return offices_.size(); }
+
+    const ManagmentSystem& office(size_t index) const { return offices_[index]->ms_; }
+
+    ManagmentSystem& office(size_t index) { return offices_[index]->ms_; }
+
+    OfficeSelection getSelection() const noexcept { return selection_; }
+
+    void setSelection(OfficeSelection selection) noexcept { selection_ = selection; }
+
+    Order* createOrder();
+
+    Order* createOrder(size_t target);
+
+    size_t selectOffice(size_t target);
+
+    bool isOffice(size_t vertex) const;
+
+    void setCurrentTime() noexcept;
+
+private:
+    void work(size_t index);
+
+    void calculateTravelTime();
+
+    size_t getLoad(size_t index) const;
+
+private:
+    Map&                                        map_;
+    std::vector<std::unique_ptr<Office>>        offices_;
+    std::vector<std::vector<int>>               travelTime_;    // travel time from each office to each vertex, seconds
+    unsigned long long int                      version_;       // version of the map when the travel time was calculated
+    OfficeSelection                             selection_;
+
+    std::vector<std::thread>                    workers_;       // workers for all offices except the first one
+    std::mutex                                  mutex_;
+    std::condition_variable                     start_;
+    std::condition_variable                     done_;
+    std::exception_ptr                          exception_;
+    std::chrono::nanoseconds                    passedTime_;
+    unsigned long long int                      generation_;    // number of the current update
+    size_t                                      pending_;       // number of workers that are updating
+    bool                                        stop_;
+};
+
+} // namespace ds
+
+#endif // !NETWORK_HPP
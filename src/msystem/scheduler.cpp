@@ -9,6 +9,7 @@
 #include"msystem.hpp"
 #include"options.hpp"
 #include"scheduler.hpp"
+#include<algorithm>
 #include<assert.h>
 
 namespace ds {
@@ -19,7 +20,9 @@ Scheduler::Scheduler(Graph::vertex_descriptor office)
     :
     ms_             { nullptr },
     office_         { office },
-    orders_         {}
+    orders_         {},
+    latency_        {},
+    totalLatency_   {}
 {
     orders_.set_capacity(Options::numComplOrders_);
 }
@@ -30,16 +33,32 @@ void Scheduler::processOrder(Order* order)
     switch (order->getStatus()) {
     case OrderStatus::ACCEPTED:
         ms_->kitchen().makeOrder(order);
+        // the containers grow on the arrival of an order, not on passing it between the stages
+        ms_->delivery().reserveOrders(ms_->kitchen().getNumberOfOrders());
         break;
     case OrderStatus::COOKING_COMPLETED:
         ms_->delivery().deliveryOrder(order);
         break;
     case OrderStatus::DELIVERING_COMPLETED:
         order->setStatus(OrderStatus::COMPLETED);
-        order->setTimeEnd(ms_->getCurrentTime());
+        order->setTimeEnd(ms_->getCurrentTick());
         orders_.push_back(order);
+        this->addLatency(order);
         break;
     }
 }
 
+void Scheduler::addLatency(const Order* order)
+{
+    // a phase lasts until the next one begins, a skipped phase lasts no time
+    cmn::tick_t end{ order->getTimeEnd() };
+    for (char i = cmn::numberOf<OrderPhase>(); i-- > 0;) {
+        const OrderPhase phase{ i };
+        const cmn::tick_t start{ std::min(order->getPhaseStart(phase), end) };
+        latency_[cmn::toUnderlying(phase)].add(static_cast<unsigned long long int>(end - start));
+        end = start;
+    }
+    totalLatency_.add(static_cast<unsigned long long int>(order->getTimeEnd() - order->getTimeStart()));
+}
+
 } // namespace ds
@@ -7,17 +7,23 @@
 #ifndef SCHEDULER_HPP
 #define SCHEDULER_HPP
 
+#include"histogram.hpp"
 #include"map.hpp"
 #include"order.hpp"
+#include<array>
 #include<boost/circular_buffer.hpp>
 #include<chrono>
 #include<utility>
 
 namespace ds {
 
+class Checkpoint;
 class ManagmentSystem;
 
 class Scheduler {
+public:
+    friend Checkpoint;
+
 public:
     Scheduler(Graph::vertex_descriptor office);
 
@@ -37,10 +43,24 @@ public:
 
     //auto getOrdersCompleted() { return std::pair{ orders_.begin(), orders_.end() }; }
 
+    // durations of the phase of all completed orders, ticks
+    const cmn::Histogram& getLatency(OrderPhase phase) const
+    {
+        return latency_[cmn::toUnderlying(phase)];
+    }
+
+    // durations of all completed orders from the acceptance to the completion, ticks
+    const cmn::Histogram& getTotalLatency() const noexcept { return totalLatency_; }
+
+private:
+    void addLatency(const Order* order);
+
 private:
     ManagmentSystem*                            ms_;
     Graph::vertex_descriptor                    office_;
     boost::circular_buffer<Order*>              orders_;        // completed orders
+    std::array<cmn::Histogram, cmn::numberOf<OrderPhase>()> latency_;
+    cmn::Histogram                              totalLatency_;
 };
 
 } // namespace ds
@@ -32,13 +32,19 @@ OptionsMap::OptionsMap()
 OptionsDelivery::OptionsDelivery()
     :
     deliveryTime_       { defDeliveryTime_ },
-    checkTimeFreeCour_  { defCheckTimeFreeCour_ }
+    checkTimeFreeCour_  { defCheckTimeFreeCour_ },
+    maxRouteLabels_     { defMaxRouteLabels_ },
+    maxRouteTime_       { defMaxRouteTime_ },
+    lateInsertion_      { false }
 {
     static_assert(minDeliveryTime_ > 0);
     static_assert(defDeliveryTime_ >= minDeliveryTime_ && defDeliveryTime_ <= maxDeliveryTime_);
     static_assert(minCheckTimeFreeCour_ > 0);
     static_assert(defCheckTimeFreeCour_ >= minCheckTimeFreeCour_
         && defCheckTimeFreeCour_ <= maxCheckTimeFreeCour_);
+    static_assert(minMaxRouteLabels_ > 0);
+    static_assert(defMaxRouteLabels_ >= minMaxRouteLabels_ && defMaxRouteLabels_ <= maxMaxRouteLabels_);
+    static_assert(defMaxRouteTime_ >= minMaxRouteTime_ && defMaxRouteTime_ <= maxMaxRouteTime_);
 }
 
 OptionsCourier::OptionsCourier()
@@ -65,13 +71,35 @@ OptionsCourier::OptionsCourier()
     static_assert(defAverageSpeed_ >= minAverageSpeed_ && defAverageSpeed_ <= maxAverageSpeed_);
 }
 
+OptionsGenerator::OptionsGenerator()
+    :
+    profile_            { defProfile_ },
+    orderRate_          { defOrderRate_ },
+    startHour_          { defStartHour_ },
+    burstFactor_        { defBurstFactor_ },
+    numHotspots_        { defNumHotspots_ },
+    hotspotShare_       { defHotspotShare_ }
+{
+    static_assert(minOrderRate_ > 0);
+    static_assert(defOrderRate_ >= minOrderRate_ && defOrderRate_ <= maxOrderRate_);
+    static_assert(maxStartHour_ < 24);
+    static_assert(defStartHour_ >= minStartHour_ && defStartHour_ <= maxStartHour_);
+    static_assert(minBurstFactor_ > 0);
+    static_assert(defBurstFactor_ >= minBurstFactor_ && defBurstFactor_ <= maxBurstFactor_);
+    static_assert(defNumHotspots_ >= minNumHotspots_ && defNumHotspots_ <= maxNumHotspots_);
+    static_assert(maxHotspotShare_ <= 100);
+    static_assert(defHotspotShare_ >= minHotspotShare_ && defHotspotShare_ <= maxHotspotShare_);
+}
+
 Options::Options()
     :
     optMap_             {},
     optDelivery_        {},
     optCourier_         {},
+    optGenerator_       {},
     fps_                { defFPS_ },
-    timeSpeed_          { defTimeSpeed_ }
+    timeSpeed_          { defTimeSpeed_ },
+    isChanged_          { false }
 {
     static_assert(minFPS_ > 0);
     static_assert(defFPS_ >= minFPS_ && defFPS_ <= maxFPS_);
@@ -79,4 +107,18 @@ Options::Options()
     static_assert(defTimeSpeed_ >= minTimeSpeed_ && defTimeSpeed_ <= maxTimeSpeed_);
 }
 
+OptionsSimulation::OptionsSimulation()
+    :
+    optDelivery_        {},
+    optCourier_         {},
+    optGenerator_       {}
+{}
+
+OptionsSimulation::OptionsSimulation(const Options& options)
+    :
+    optDelivery_        { options.optDelivery_ },
+    optCourier_         { options.optCourier_ },
+    optGenerator_       { options.optGenerator_ }
+{}
+
 } // namespace ds
@@ -43,7 +43,7 @@ public:
 };
 
 
-class OptionsDelivery : OptionsBase {
+class OptionsDelivery {
 public:
     static constexpr unsigned int defDeliveryTime_{ 60 * 55 };  // seconds
     static constexpr unsigned int minDeliveryTime_{ 60 * 30 };  // seconds
@@ -53,16 +53,29 @@ public:
     static constexpr unsigned int minCheckTimeFreeCour_{ 1 };   // seconds
     static constexpr unsigned int maxCheckTimeFreeCour_{ 10 };  // seconds
 
+    static constexpr unsigned int defMaxRouteLabels_{ 200000 }; // labels of the route search
+    static constexpr unsigned int minMaxRouteLabels_{ 1000 };
+    static constexpr unsigned int maxMaxRouteLabels_{ 10000000 };
+
+    // the routes found within a time budget depend on the speed and the load of the machine,
+    // so the budget is off by default and the runs are repeated exactly
+    static constexpr unsigned int defMaxRouteTime_{ 0 };        // milliseconds, 0 - no budget
+    static constexpr unsigned int minMaxRouteTime_{ 0 };        // milliseconds
+    static constexpr unsigned int maxMaxRouteTime_{ 1000 };     // milliseconds
+
 public:
     OptionsDelivery();
 
 public:
     int                             deliveryTime_;              // seconds
     int                             checkTimeFreeCour_;         // time to check free couriers
+    int                             maxRouteLabels_;            // budget of the route search
+    int                             maxRouteTime_;              // budget of the route search, milliseconds, 0 - none
+    bool                            lateInsertion_;             // add orders to routes being accepted
 };
 
 
-class OptionsCourier : OptionsBase {
+class OptionsCourier {
 public:
     static constexpr unsigned int defInaccessibleTime_{ 5 };    // seconds
 
@@ -103,6 +116,43 @@ public:
 };
 
 
+class OptionsGenerator {
+public:
+    static constexpr unsigned int defProfile_{ 0 };             // ArrivalProfile::POISSON
+
+    static constexpr unsigned int defOrderRate_{ 15 };          // orders per hour
+    static constexpr unsigned int minOrderRate_{ 1 };           // orders per hour
+    static constexpr unsigned int maxOrderRate_{ 5000 };        // orders per hour
+
+    static constexpr unsigned int defStartHour_{ 10 };          // hour of the day
+    static constexpr unsigned int minStartHour_{ 0 };           // hour of the day
+    static constexpr unsigned int maxStartHour_{ 23 };          // hour of the day
+
+    static constexpr unsigned int defBurstFactor_{ 5 };
+    static constexpr unsigned int minBurstFactor_{ 1 };
+    static constexpr unsigned int maxBurstFactor_{ 20 };
+
+    static constexpr unsigned int defNumHotspots_{ 3 };
+    static constexpr unsigned int minNumHotspots_{ 0 };
+    static constexpr unsigned int maxNumHotspots_{ 10 };
+
+    static constexpr unsigned int defHotspotShare_{ 30 };       // percent
+    static constexpr unsigned int minHotspotShare_{ 0 };        // percent
+    static constexpr unsigned int maxHotspotShare_{ 100 };      // percent
+
+public:
+    OptionsGenerator();
+
+public:
+    int                             profile_;                   // ArrivalProfile
+    int                             orderRate_;                 // orders per hour
+    int                             startHour_;                 // hour of the day at the start of the simulation
+    int                             burstFactor_;               // rate multiplier during a burst
+    int                             numHotspots_;
+    int                             hotspotShare_;              // percent
+};
+
+
 class Options : OptionsBase {
 public:
     static constexpr unsigned int numComplOrders_{ 20 };        // number of completed orders
@@ -130,13 +180,30 @@ public:
     OptionsMap                      optMap_;
     OptionsDelivery                 optDelivery_;
     OptionsCourier                  optCourier_;
+    OptionsGenerator                optGenerator_;
 
     int                             fps_;                       // frames per second
     int                             timeSpeed_;
+    bool                            isChanged_;                 // the simulation options were edited since they were published
 private:
     static Options                  uniqueInstance_;
 };
 
+
+// Options of one simulation, the copy of the delivery, courier and generator options:
+// every managment system keeps its own one, which does not change during an update of the system
+class OptionsSimulation {
+public:
+    OptionsSimulation();
+
+    explicit OptionsSimulation(const Options& options);
+
+public:
+    OptionsDelivery                 optDelivery_;
+    OptionsCourier                  optCourier_;
+    OptionsGenerator                optGenerator_;
+};
+
 } // namespace ds
 
 #endif // !OPTIONS_HPP
@@ -11,7 +11,7 @@ namespace ds {
 
 using namespace std;
 
-string toString(FoodName value)
+string_view toString(FoodName value) noexcept
 {
     switch (value) {
     case FoodName::PEPPERONI:
@@ -50,7 +50,7 @@ string toString(FoodName value)
     static_assert(cmn::numberOf<FoodName>() == 15);
 }
 
-string toString(FoodStatus value)
+string_view toString(FoodStatus value) noexcept
 {
     switch (value) {
     case FoodStatus::WAITING_FOR_MAKING:
@@ -8,11 +8,18 @@
 #define FOOD_HPP
 
 #include<chrono>
-#include<string>
+#include<string_view>
+#include<type_traits>
 #include<utility>
 
 namespace ds {
 
+class Checkpoint;
+class Order;
+
+// handle of the order in 'OrderTable', it stays valid while the table grows
+enum class OrderHandle : unsigned int;
+
 enum class FoodName : char {
     __INVALID = -1,                 /// invalid, must be the first
     // vvv NAMES vvv
@@ -61,26 +68,29 @@ enum class FoodStatus : char {
     __END                           /// must be the last
 };
 
-std::string toString(FoodName value);
+std::string_view toString(FoodName value) noexcept;
 
-std::string toString(FoodStatus value);
+std::string_view toString(FoodStatus value) noexcept;
 
 ///************************************************************************************************
 
 class Food {
+public:
+    friend Checkpoint;
+    friend Order;
+
 public:
     static constexpr std::chrono::seconds doughTime_{ 60 * 2 + 30 };
 
 public:
-    Food(unsigned short quantity, const FoodName name) noexcept
-        : qty_{ quantity }, name_{ name }, status_{ FoodStatus::__INVALID } {}
+    static constexpr OrderHandle noOrder_{ ~0u };
 
-    Food(const Food&) = delete;
-    Food& operator=(const Food&) = delete;
-    Food(Food&&) = default;
-    Food& operator=(Food&&) = default;
+public:
+    Food() noexcept
+        : order_{ noOrder_ }, qty_{ 0 }, name_{ FoodName::__INVALID }, status_{ FoodStatus::__INVALID } {}
 
-    virtual ~Food() noexcept {}
+    Food(unsigned short quantity, const FoodName name) noexcept
+        : order_{ noOrder_ }, qty_{ quantity }, name_{ name }, status_{ FoodStatus::__INVALID } {}
 
 public:
     unsigned short getQuantity() const noexcept { return qty_; }
@@ -93,7 +103,8 @@ public:
 
     FoodStatus getStatus() const noexcept { return status_; }
 
-    void setStatus(FoodStatus status) noexcept { status_ = status; }
+    // 'noOrder_' until the food is set to an order
+    OrderHandle getOrderHandle() const noexcept { return order_; }
 
     std::chrono::seconds getPreparationTime() const noexcept;
 
@@ -102,11 +113,15 @@ public:
     std::chrono::seconds getTotalTime() const noexcept;
 
 private:
+    OrderHandle                                 order_;         // order containing the food
     unsigned short                              qty_;
-    const FoodName                              name_;
+    FoodName                                    name_;
     FoodStatus                                  status_;
 };
 
+// food is kept inline in orders and copied as plain bytes
+static_assert(std::is_trivially_copyable_v<Food>);
+
 inline std::chrono::seconds Food::getTotalTime() const noexcept
 {
     return getPreparationTime() + getCookingTime();
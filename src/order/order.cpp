@@ -6,13 +6,28 @@
 
 #include"common.hpp"
 #include"order.hpp"
+#include"trace.hpp"
+#include<algorithm>
+#include<assert.h>
 #include<utility>
 
 namespace ds {
 
 using namespace std;
 
-string toString(OrderStatus value)
+namespace {
+
+const cmn::TraceCategory orderTrace{
+    u8"order", [](int state) { return toString(static_cast<OrderStatus>(state)); }
+};
+
+const cmn::TraceCategory foodTrace{
+    u8"food", [](int state) { return toString(static_cast<FoodStatus>(state)); }
+};
+
+} // namespace
+
+string_view toString(OrderStatus value) noexcept
 {
     switch (value) {
     case OrderStatus::__INVALID:
@@ -43,33 +58,235 @@ string toString(OrderStatus value)
     static_assert(cmn::numberOf<OrderStatus>() == 10);
 }
 
+string_view toString(OrderPhase value) noexcept
+{
+    switch (value) {
+    case OrderPhase::__INVALID:
+        return u8"INVALID PHASE";
+    case OrderPhase::QUEUE:
+        return u8"Queue";
+    case OrderPhase::COOKING:
+        return u8"Cooking";
+    case OrderPhase::WAITING_FOR_COURIER:
+        return u8"Waiting for courier";
+    case OrderPhase::DRIVING:
+        return u8"Driving";
+    default:
+        return u8"UNKNOWN";
+    }
+    static_assert(cmn::numberOf<OrderPhase>() == 4);
+}
+
+///************************************************************************************************
+
+OrderTable::OrderTable()
+    :
+    id_             {},
+    target_         {},
+    timeStart_      {},
+    timeEnd_        {},
+    readyTime_      {},
+    status_         {},
+    isPaid_         {},
+    phaseStart_     {},
+    statusCount_    {},
+    tick_           { 0 }
+{}
+
+OrderHandle OrderTable::addOrder(OrderID orderID, size_t target, cmn::tick_t timeStart)
+{
+    const OrderHandle handle{ static_cast<unsigned int>(status_.size()) };
+    id_.push_back(orderID);
+    target_.push_back(target);
+    timeStart_.push_back(timeStart);
+    timeEnd_.push_back(timeStart);
+    readyTime_.push_back(cmn::maxTick);
+    status_.push_back(OrderStatus::__INVALID);
+    isPaid_.push_back(0);
+    phaseStart_.emplace_back();
+    phaseStart_.back().fill(cmn::maxTick);
+    phaseStart_.back()[static_cast<size_t>(OrderPhase::QUEUE)] = timeStart;
+    return handle;
+}
+
+void OrderTable::setStatus(OrderHandle h, OrderStatus status)
+{
+    assert(cmn::isValidEnum(status));
+    OrderStatus& current{ status_[index(h)] };
+    if (current == status) {
+        return;
+    }
+    if (current != OrderStatus::__INVALID) {
+        --statusCount_[static_cast<size_t>(current)];
+    }
+    ++statusCount_[static_cast<size_t>(status)];
+    current = status;
+    auto& phaseStart{ phaseStart_[index(h)] };
+    switch (status) {
+    case OrderStatus::COOKING:
+        phaseStart[static_cast<size_t>(OrderPhase::COOKING)] = tick_;
+        break;
+    case OrderStatus::COOKING_COMPLETED:
+        phaseStart[static_cast<size_t>(OrderPhase::WAITING_FOR_COURIER)] = tick_;
+        break;
+    case OrderStatus::DELIVERING:
+        phaseStart[static_cast<size_t>(OrderPhase::DRIVING)] = tick_;
+        break;
+    default:
+        break;
+    }
+    static_assert(cmn::numberOf<OrderPhase>() == 4);
+}
+
+void OrderTable::findStatus(OrderStatus status, vector<OrderHandle>& handles) const
+{
+    handles.clear();
+    for (size_t i = 0; i < status_.size(); ++i) {
+        if (status_[i] == status) {
+            handles.push_back(OrderHandle{ static_cast<unsigned int>(i) });
+        }
+    }
+}
+
 ///************************************************************************************************
 
-Order::Order(const OrderID orderID, const size_t target, const time_point_t timeStart)
+Order::Order(OrderTable& table, OrderHandle handle)
     :
-    orderID_        { orderID },
-    target_         { target },
-    timeStart_      { timeStart },
-    timeEnd_        { timeStart },
+    table_          { table },
+    handle_         { handle },
     food_           {},
-    status_         { OrderStatus::__INVALID },
-    isPaid_         { false }
+    foodCount_      {}
 {}
 
-void Order::setFood(std::vector<Food> food)
+void Order::setFood(const food_list_t& food)
 {
-    food_ = std::move(food);
+    food_ = food;
+    foodCount_.fill(0);
     for (auto& f : food_) {
-        f.setStatus(FoodStatus::WAITING_FOR_MAKING);
+        f.order_ = handle_;
+        f.status_ = FoodStatus::WAITING_FOR_MAKING;
+        ++foodCount_[static_cast<size_t>(FoodStatus::WAITING_FOR_MAKING)];
     }
 }
 
-Route::Route(ManagmentSystem& ms, vector<Order*> orders,
+void Order::setStatus(OrderStatus status)
+{
+    if (this->getStatus() == status) {
+        return;
+    }
+    cmn::Tracer& tracer{ cmn::Tracer::instance() };
+    if (tracer.isEnabled()) {
+        // the completed and the cancelled orders are not traced further
+        const bool isFinished{ status == OrderStatus::COMPLETED || status == OrderStatus::CANCELLED };
+        tracer.addTransition(orderTrace, cmn::toUnderlying(getID()),
+            cmn::toUnderlying(getStatus()), isFinished ? -1 : cmn::toUnderlying(status));
+    }
+    table_.setStatus(handle_, status);
+}
+
+void Order::setFoodStatus(Food& food, FoodStatus status)
+{
+    assert(food.order_ == handle_);
+    assert(&food >= food_.begin() && &food < food_.end());
+    const FoodStatus oldStatus{ food.status_ };
+    if (oldStatus == status) {
+        return;
+    }
+    cmn::Tracer& tracer{ cmn::Tracer::instance() };
+    if (tracer.isEnabled()) {
+        // the food is traced apart from the other food of the order, the done food is not traced
+        const size_t index( &food - food_.begin() );
+        tracer.addTransition(foodTrace, cmn::toUnderlying(getID()) * maxFood_ + index,
+            cmn::toUnderlying(oldStatus), status == FoodStatus::DONE ? -1 : cmn::toUnderlying(status));
+    }
+    if (oldStatus != FoodStatus::__INVALID) {
+        assert(foodCount_[static_cast<size_t>(oldStatus)] > 0);
+        --foodCount_[static_cast<size_t>(oldStatus)];
+    }
+    if (status != FoodStatus::__INVALID) {
+        ++foodCount_[static_cast<size_t>(status)];
+    }
+    food.status_ = status;
+}
+
+Route::Route(const Map& map, vector<Order*> orders,
     vector<Graph::edge_descriptor> path)
     :
-    ms_             { ms },
+    map_            { map },
     orders_         { std::move(orders) },
-    path_           { std::move(path) }
-{}
+    path_           { std::move(path) },
+    stops_          {},
+    distances_      {}
+{
+    // the route later becomes the way back to the office, which is a shortest path
+    // and so has less edges than the map has vertices
+    path_.reserve(map_.graph().m_vertices.size());
+    distances_.reserve(map_.graph().m_vertices.size());
+    calculateStops();
+    calculateDistances();
+}
+
+void Route::insertOrder(size_t position, Order* order,
+    const vector<Graph::edge_descriptor>& pathTo,
+    const vector<Graph::edge_descriptor>& pathFrom)
+{
+    assert(order != nullptr);
+    assert(position <= orders_.size());
+    // replace the part of the path leading to the order at 'position'
+    // with the detour through the target of the new order
+    const size_t first{ position == 0 ? 0 : stops_[position - 1] + 1 };
+    const size_t last{ position == orders_.size() ? path_.size() : stops_[position] + 1 };
+    auto iter{ path_.erase(path_.begin() + first, path_.begin() + last) };
+    iter = path_.insert(iter, pathFrom.cbegin(), pathFrom.cend());
+    path_.insert(iter, pathTo.cbegin(), pathTo.cend());
+    orders_.insert(orders_.begin() + position, order);
+    calculateStops();
+    calculateDistances();
+}
+
+void Route::setPath(const vector<Graph::edge_descriptor>& path)
+{
+    orders_.clear();
+    path_.assign(path.cbegin(), path.cend());
+    calculateStops();
+    calculateDistances();
+}
+
+void Route::setPath(const vector<Order*>& orders, const vector<Graph::edge_descriptor>& path)
+{
+    orders_.assign(orders.cbegin(), orders.cend());
+    path_.assign(path.cbegin(), path.cend());
+    calculateStops();
+    calculateDistances();
+}
+
+void Route::calculateStops()
+{
+    stops_.clear();
+    stops_.reserve(orders_.size());
+    size_t i{ 0 };
+    for (const Order* order : orders_) {
+        if (stops_.empty() == false && path_[i].m_target != order->getTarget()) {
+            ++i;
+        }
+        while (i < path_.size() && path_[i].m_target != order->getTarget()) {
+            ++i;
+        }
+        assert(i < path_.size());
+        stops_.push_back(i);
+    }
+}
+
+void Route::calculateDistances()
+{
+    const auto& graph{ map_.graph() };
+    distances_.clear();
+    distances_.reserve(path_.size());
+    long long int distance{ 0 };
+    for (const auto& edge : path_) {
+        distance += graph[edge].distance_;
+        distances_.push_back(distance);
+    }
+}
 
 } // namespace ds
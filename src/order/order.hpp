@@ -7,11 +7,15 @@
 #ifndef ORDER_HPP
 #define ORDER_HPP
 
+#include"common.hpp"
 #include"food.hpp"
 #include"map.hpp"
+#include"static_vector.hpp"
+#include<array>
+#include<assert.h>
 #include<chrono>
 #include<memory>
-#include<string>
+#include<string_view>
 #include<type_traits>
 #include<vector>
 
@@ -37,66 +41,183 @@ enum class OrderStatus : char {
     __END                           /// must be the last
 };
 
-std::string toString(OrderStatus value);
+std::string_view toString(OrderStatus value) noexcept;
+
+// consecutive phases of an order from the acceptance to the completion
+enum class OrderPhase : char {
+    __INVALID = -1,                 /// invalid, must be the first
+    // vvv PHASES vvv
+    QUEUE,                          // waiting for the first kitchener
+    COOKING,
+    WAITING_FOR_COURIER,
+    DRIVING,                        // from the acceptance by a courier to the delivery
+    // ^^^ PHASES ^^^
+    __NUMBER_OF,
+    __END                           /// must be the last
+};
+
+std::string_view toString(OrderPhase value) noexcept;
 
 ///************************************************************************************************
 
+class Checkpoint;
+
+enum class OrderHandle : unsigned int {};
+
+// Data of all orders in contiguous columns indexed by the order handle
+class OrderTable {
+public:
+    friend Checkpoint;
+
+public:
+    OrderTable();
+
+    OrderTable(const OrderTable&) = delete;
+    OrderTable& operator=(const OrderTable&) = delete;
+
+    virtual ~OrderTable() noexcept {}
+
+public:
+    OrderHandle addOrder(OrderID orderID, size_t target, cmn::tick_t timeStart);
+
+    size_t size() const noexcept { return status_.size(); }
+
+    OrderID getID(OrderHandle h) const { return id_[index(h)]; }
+
+    size_t getTarget(OrderHandle h) const { return target_[index(h)]; }
+
+    cmn::tick_t getTimeStart(OrderHandle h) const { return timeStart_[index(h)]; }
+
+    cmn::tick_t getTimeEnd(OrderHandle h) const { return timeEnd_[index(h)]; }
+
+    void setTimeEnd(OrderHandle h, cmn::tick_t timeEnd) { timeEnd_[index(h)] = timeEnd; }
+
+    cmn::tick_t getReadyTime(OrderHandle h) const { return readyTime_[index(h)]; }
+
+    void setReadyTime(OrderHandle h, cmn::tick_t readyTime) { readyTime_[index(h)] = readyTime; }
+
+    OrderStatus getStatus(OrderHandle h) const { return status_[index(h)]; }
+
+    // the status that begins a phase stamps the start of the phase with the current time
+    void setStatus(OrderHandle h, OrderStatus status);
+
+    // time of the last update, it stamps the phases
+    void setCurrentTick(cmn::tick_t tick) noexcept { tick_ = tick; }
+
+    // the phase that has not begun yet starts at 'cmn::maxTick'
+    cmn::tick_t getPhaseStart(OrderHandle h, OrderPhase phase) const
+    {
+        return phaseStart_[index(h)][static_cast<size_t>(phase)];
+    }
+
+    bool isPaid(OrderHandle h) const { return isPaid_[index(h)] != 0; }
+
+    void isPaid(OrderHandle h, bool value) { isPaid_[index(h)] = value; }
+
+    const std::vector<OrderStatus>& getStatuses() const noexcept { return status_; }
+
+    size_t countStatus(OrderStatus status) const
+    {
+        return statusCount_[static_cast<size_t>(status)];
+    }
+
+    void findStatus(OrderStatus status, std::vector<OrderHandle>& handles) const;
+
+private:
+    size_t index(OrderHandle h) const
+    {
+        assert(static_cast<size_t>(h) < status_.size());
+        return static_cast<size_t>(h);
+    }
+
+private:
+    std::vector<OrderID>                        id_;
+    std::vector<size_t>                         target_;
+    std::vector<cmn::tick_t>                    timeStart_;
+    std::vector<cmn::tick_t>                    timeEnd_;
+    std::vector<cmn::tick_t>                    readyTime_;     // predicted end of cooking, 'cmn::maxTick' if unknown
+    std::vector<OrderStatus>                    status_;
+    std::vector<unsigned char>                  isPaid_;
+    std::vector<std::array<cmn::tick_t, cmn::numberOf<OrderPhase>()>> phaseStart_;
+    std::array<size_t, cmn::numberOf<OrderStatus>()> statusCount_; // number of orders in each status
+    cmn::tick_t                                 tick_;
+};
+
+///************************************************************************************************
+
+// Order with its food, the rest of the order data is kept in 'OrderTable'
 class Order {
 public:
-    using time_point_t = std::chrono::system_clock::time_point;
+    friend Checkpoint;
 
 public:
-    Order(const OrderID orderID, const size_t target, const time_point_t timeStart);
+    static constexpr size_t maxFood_{ 6 };                    // maximum number of food items
 
+    using food_list_t = cmn::StaticVector<Food, maxFood_>;
+
+public:
+    Order(OrderTable& table, OrderHandle handle);
+
+    // the kitchen refers to the food, so the order is never copied or moved
     Order(const Order&) = delete;
     Order& operator=(const Order&) = delete;
-    Order(Order&&) = default;
-    Order& operator=(Order&&) = default;
-
-    virtual ~Order() noexcept {}
 
 public:
-    OrderID getID() const noexcept { return orderID_; }
+    OrderHandle getHandle() const noexcept { return handle_; }
+
+    OrderID getID() const { return table_.getID(handle_); }
 
-    size_t getTarget() const noexcept { return target_; }
+    size_t getTarget() const { return table_.getTarget(handle_); }
 
-    time_point_t getTimeStart() const noexcept { return timeStart_; }
+    cmn::tick_t getTimeStart() const { return table_.getTimeStart(handle_); }
 
-    time_point_t getTimeEnd() const noexcept { return timeEnd_; }
+    cmn::tick_t getTimeEnd() const { return table_.getTimeEnd(handle_); }
 
-    void setTimeEnd(time_point_t timeEnd) { timeEnd_ = timeEnd; }
+    cmn::tick_t getPhaseStart(OrderPhase phase) const { return table_.getPhaseStart(handle_, phase); }
 
-    const std::vector<Food>& getFood() const noexcept { return food_; }
+    void setTimeEnd(cmn::tick_t timeEnd) { table_.setTimeEnd(handle_, timeEnd); }
 
-    std::vector<Food>& getFood() noexcept { return food_; }
+    cmn::tick_t getReadyTime() const { return table_.getReadyTime(handle_); }
 
-    void setFood(std::vector<Food> food);
+    void setReadyTime(cmn::tick_t readyTime) { table_.setReadyTime(handle_, readyTime); }
 
-    OrderStatus getStatus() const noexcept { return status_; }
+    const food_list_t& getFood() const noexcept { return food_; }
 
-    void setStatus(OrderStatus status) noexcept { status_ = status; }
+    food_list_t& getFood() noexcept { return food_; }
 
-    bool isPaid() const noexcept { return isPaid_; }
+    void setFood(const food_list_t& food);
 
-    void isPaid(bool value) noexcept { isPaid_ = value; }
+    size_t getNumberOfFood(FoodStatus status) const noexcept
+    {
+        return foodCount_[static_cast<size_t>(status)];
+    }
+
+    // the food must be of the order
+    void setFoodStatus(Food& food, FoodStatus status);
+
+    OrderStatus getStatus() const { return table_.getStatus(handle_); }
+
+    void setStatus(OrderStatus status);
+
+    bool isPaid() const { return table_.isPaid(handle_); }
+
+    void isPaid(bool value) { table_.isPaid(handle_, value); }
 
 private:
-    const OrderID                               orderID_;
-    const size_t                                target_;
-    const time_point_t                          timeStart_;
-    time_point_t                                timeEnd_;
-    std::vector<Food>                           food_;
-    OrderStatus                                 status_;
-    bool                                        isPaid_;
+    OrderTable&                                 table_;
+    const OrderHandle                           handle_;
+    food_list_t                                 food_;          // inline, the food keeps the handle of the order
+    std::array<unsigned short, cmn::numberOf<FoodStatus>()> foodCount_; // number of food items in each status
 };
 
-///************************************************************************************************
+// the orders are walked by the kitchen and the checkpoints, they are kept within two cache lines
+static_assert(sizeof(Order) <= 2 * 64);
 
-class ManagmentSystem;
+///************************************************************************************************
 
 class Route {
 public:
-    Route(ManagmentSystem& ms, std::vector<Order*> orders,
+    Route(const Map& map, std::vector<Order*> orders,
         std::vector<Graph::edge_descriptor> path);
 
     Route(const Route&) = delete;
@@ -113,10 +234,31 @@ public:
 
     const std::vector<Graph::edge_descriptor>& getPath() const { return path_; }
 
+    const std::vector<size_t>& getStops() const noexcept { return stops_; }
+
+    const std::vector<long long int>& getDistances() const noexcept { return distances_; }
+
+    void insertOrder(size_t position, Order* order,
+        const std::vector<Graph::edge_descriptor>& pathTo,
+        const std::vector<Graph::edge_descriptor>& pathFrom);
+
+    // the route without orders, the storage of the route is reused
+    void setPath(const std::vector<Graph::edge_descriptor>& path);
+
+    // the route through the targets of the orders, the storage of the route is reused
+    void setPath(const std::vector<Order*>& orders, const std::vector<Graph::edge_descriptor>& path);
+
+private:
+    void calculateStops();
+
+    void calculateDistances();
+
 private:
-    ManagmentSystem&                            ms_;
+    const Map&                                  map_;
     std::vector<Order*>                         orders_;
     std::vector<Graph::edge_descriptor>         path_;
+    std::vector<size_t>                         stops_;         // index of the path edge leading to the target of each order
+    std::vector<long long int>                  distances_;     // distance from the start to the end of each path edge, meters
 };
 
 } // namespace ds
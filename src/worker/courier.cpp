@@ -8,13 +8,14 @@
 #include"courier.hpp"
 #include"msystem.hpp"
 #include"options.hpp"
+#include<algorithm>
 #include<utility>
 
 namespace ds {
 
 using namespace std;
 
-string toString(CourierStatus value)
+string_view toString(CourierStatus value) noexcept
 {
     switch (value) {
     case CourierStatus::__INVALID:
@@ -39,18 +40,8 @@ string toString(CourierStatus value)
 
 ///************************************************************************************************
 
-CourierInaccessible     CourierInaccessible::state_{};
-CourierWaiting          CourierWaiting::state_{};
-CourierAccepting        CourierAccepting::state_{};
-CourierMovement         CourierMovement::state_{};
-CourierDeliveryPayment  CourierDeliveryPayment::state_{};
-CourierReturning        CourierReturning::state_{};
-
-///************************************************************************************************
-
 Courier::Courier(ManagmentSystem& ms, WorkerID workerID)
     :
-    state_          { &CourierWaiting::instance() },
     ms_             { ms },
     route_          { nullptr },
     passedTime_     { 0 },
@@ -61,9 +52,34 @@ Courier::Courier(ManagmentSystem& ms, WorkerID workerID)
     fullDist_       { 0 },
     curLocation_    { Courier::getInaccessibleLocation() },
     id_             { workerID },
+    status_         { CourierStatus::WAITING_FOR_NEXT },
     prevStatus_     { CourierStatus::__INVALID }
 {}
 
+void Courier::insertOrder(size_t position, Order* order,
+    const vector<Graph::edge_descriptor>& pathTo,
+    const vector<Graph::edge_descriptor>& pathFrom)
+{
+    assert(getStatus() == CourierStatus::ACCEPTING_ORDER);
+    route_->insertOrder(position, order, pathTo, pathFrom);
+    if (prevStatus_ == CourierStatus::ACCEPTING_ORDER) {
+        // the route has been changed, so the iterators are set again
+        curOrder_ = route_->getOrders().begin();
+        curEdge_ = route_->getPath().cbegin();
+        order->setStatus(OrderStatus::DELIVERING);
+    }
+}
+
+chrono::nanoseconds Courier::getTimeToDeparture() const noexcept
+{
+    assert(getStatus() == CourierStatus::ACCEPTING_ORDER);
+    if (prevStatus_ != CourierStatus::ACCEPTING_ORDER) {
+        // acceptance has not started yet, so the longest acceptance is expected
+        return chrono::seconds{ ms_.options().optCourier_.acceptanceTime_ };
+    }
+    return makingTime_ - passedTime_;
+}
+
 inline ImVec2 Courier::getLocation(size_t target) const
 {
     return ImVec2{
@@ -77,15 +93,33 @@ inline ImVec2 Courier::getOfficeLocation() const
     return getLocation(ms_.scheduler().getOffice());
 }
 
-inline long long int Courier::calculateFullDistance() const
+inline size_t Courier::getCurrentStop() const
 {
-    const auto& edge{ *curEdge_ };
-    return ms_.map().graph()[edge].distance_ * nano::den;
+    if (route_->getOrders().empty()) {
+        // the route back to the office
+        return route_->getPath().size() - 1;
+    }
+    return route_->getStops()[curOrder_ - route_->getOrders().begin()];
 }
 
-ImVec2 Courier::calculateCurrentLocation()
+Courier::edge_const_iterator_t Courier::findCurrentEdge() const
 {
-    const double t{ double(passedDist_) / fullDist_ };
+    const auto& distances{ route_->getDistances() };
+    const auto first{ distances.cbegin() + (curEdge_ - route_->getPath().cbegin()) };
+    const auto iter{ upper_bound(first, distances.cend(), passedDist_ / nano::den) };
+    assert(iter != distances.cend());
+    return route_->getPath().cbegin() + (iter - distances.cbegin());
+}
+
+ImVec2 Courier::calculateCurrentLocation() const
+{
+    const auto& distances{ route_->getDistances() };
+    const size_t i( curEdge_ - route_->getPath().cbegin() );
+    const long long int edgeStart{ (i == 0 ? 0 : distances[i - 1]) * nano::den };
+    const long long int edgeEnd{ distances[i] * nano::den };
+    const double t{
+        edgeEnd > edgeStart ? double(passedDist_ - edgeStart) / (edgeEnd - edgeStart) : 1.0
+    };
     const auto& graph{ ms_.map().graph() };
     const auto& edge{ *curEdge_ };
     const int x{ int(
@@ -97,33 +131,79 @@ ImVec2 Courier::calculateCurrentLocation()
     return ImVec2{ float(x), float(y) };
 }
 
+void Courier::updateStatus(chrono::nanoseconds passedTime)
+{
+    switch (status_) {
+    case CourierStatus::INACCESSIBLE:
+        updateInaccessible(*this, passedTime);
+        break;
+    case CourierStatus::WAITING_FOR_NEXT:
+        updateWaiting(*this, passedTime);
+        break;
+    case CourierStatus::ACCEPTING_ORDER:
+        updateAccepting(*this, passedTime);
+        break;
+    case CourierStatus::MOVEMENT_TO_CUSTOMER:
+        updateMovement(*this, passedTime);
+        break;
+    case CourierStatus::DELIVERY_AND_PAYMENT:
+        updateDeliveryPayment(*this, passedTime);
+        break;
+    case CourierStatus::RETURNING_TO_OFFICE:
+        updateReturning(*this, passedTime);
+        break;
+    default:
+        assert(false);
+        break;
+    }
+    static_assert(cmn::numberOf<CourierStatus>() == 6);
+}
+
+bool Courier::moveAlongRoute()
+{
+    const long long int speed{ ms_.options().optCourier_.averageSpeed_ };
+    passedDist_ += passedTime_.count() * speed;
+    passedTime_ = chrono::nanoseconds{ 0 };
+    if (passedDist_ >= fullDist_) {
+        // the time left after reaching the stop is carried over to the next state
+        passedTime_ = chrono::nanoseconds{ (passedDist_ - fullDist_) / speed };
+        passedDist_ = fullDist_;
+        curEdge_ = route_->getPath().cbegin() + getCurrentStop();
+        curLocation_ = getLocation(curEdge_->m_target);
+        return true;
+    }
+    curEdge_ = findCurrentEdge();
+    curLocation_ = calculateCurrentLocation();
+    return false;
+}
+
 ///************************************************************************************************
 
-void CourierInaccessible::update(Courier& courier, std::chrono::nanoseconds passedTime)
+void Courier::updateInaccessible(Courier& courier, chrono::nanoseconds passedTime)
 {
     if (courier.prevStatus_ != CourierStatus::INACCESSIBLE) {
         courier.prevStatus_ = CourierStatus::INACCESSIBLE;
         courier.curLocation_ = courier.getInaccessibleLocation();
-        courier.route_.reset();
+        courier.ms_.delivery().releaseRoute(courier.route_);
         courier.curOrder_ = vector<Order*>::iterator{};
         courier.curEdge_ = Courier::edge_const_iterator_t{};
         int random{ cmn::getRandomNumber(1, 100) };
         courier.makingTime_ =
-            (random >= 1 && random <= Options::instance().optCourier_.pauseChance_) ?
+            (random >= 1 && random <= courier.ms_.options().optCourier_.pauseChance_) ?
             chrono::seconds{ cmn::getRandomNumber(
                     OptionsCourier::minPauseTime_,
-                    Options::instance().optCourier_.pauseTime_
+                    courier.ms_.options().optCourier_.pauseTime_
             )} :
             chrono::seconds{ OptionsCourier::defInaccessibleTime_ };
     }
     courier.passedTime_ += passedTime;
     if (courier.passedTime_ >= courier.makingTime_) {
         courier.passedTime_ -= courier.makingTime_;
-        this->changeState(courier, CourierWaiting::instance());
+        courier.status_ = CourierStatus::WAITING_FOR_NEXT;
     }
 }
 
-void CourierWaiting::update(Courier& courier, std::chrono::nanoseconds passedTime)
+void Courier::updateWaiting(Courier& courier, chrono::nanoseconds passedTime)
 {
     if (courier.prevStatus_ != CourierStatus::WAITING_FOR_NEXT) {
         courier.prevStatus_ = CourierStatus::WAITING_FOR_NEXT;
@@ -134,20 +214,21 @@ void CourierWaiting::update(Courier& courier, std::chrono::nanoseconds passedTim
     courier.makingTime_ += passedTime;
     if (courier.route_ != nullptr) {
         courier.passedTime_ -= courier.makingTime_;
-        this->changeState(courier, CourierAccepting::instance());
+        courier.status_ = CourierStatus::ACCEPTING_ORDER;
     }
 }
 
-void CourierAccepting::update(Courier& courier, std::chrono::nanoseconds passedTime)
+void Courier::updateAccepting(Courier& courier, chrono::nanoseconds passedTime)
 {
     if (courier.prevStatus_ != CourierStatus::ACCEPTING_ORDER) {
         courier.prevStatus_ = CourierStatus::ACCEPTING_ORDER;
         courier.curOrder_ = courier.route_->getOrders().begin();
         courier.curEdge_ = courier.route_->getPath().cbegin();
         courier.curLocation_ = courier.getOfficeLocation();
+        courier.passedDist_ = 0;
         courier.makingTime_ = chrono::seconds{ cmn::getRandomNumber(
             OptionsCourier::minAcceptanceTime_,
-            Options::instance().optCourier_.acceptanceTime_
+            courier.ms_.options().optCourier_.acceptanceTime_
         )};
         for (Order* order : courier.route_->getOrders()) {
             order->setStatus(OrderStatus::DELIVERING);
@@ -156,55 +237,40 @@ void CourierAccepting::update(Courier& courier, std::chrono::nanoseconds passedT
     courier.passedTime_ += passedTime;
     if (courier.passedTime_ >= courier.makingTime_) {
         courier.passedTime_ -= courier.makingTime_;
-        this->changeState(courier, CourierMovement::instance());
+        courier.status_ = CourierStatus::MOVEMENT_TO_CUSTOMER;
     }
 }
 
-void CourierMovement::update(Courier& courier, std::chrono::nanoseconds passedTime)
+void Courier::updateMovement(Courier& courier, chrono::nanoseconds passedTime)
 {
     if (courier.prevStatus_ != CourierStatus::MOVEMENT_TO_CUSTOMER) {
         courier.prevStatus_ = CourierStatus::MOVEMENT_TO_CUSTOMER;
-        courier.passedDist_ = 0;
-        courier.fullDist_ = courier.calculateFullDistance();
-        courier.makingTime_ = chrono::nanoseconds{ 0 };
+        courier.fullDist_ = courier.route_->getDistances()[courier.getCurrentStop()] * nano::den;
     }
     courier.passedTime_ += passedTime;
-    courier.makingTime_ += passedTime;
-    courier.passedDist_ += passedTime.count() * Options::instance().optCourier_.averageSpeed_;
-    if (courier.passedDist_ >= courier.fullDist_) {
-        courier.passedDist_ -= courier.fullDist_;
-        if (courier.curEdge_->m_target == (*courier.curOrder_)->getTarget()) {
-            courier.curLocation_ = courier.getLocation(courier.curEdge_->m_target);
-            courier.passedTime_ -= courier.makingTime_;
-            this->changeState(courier, CourierDeliveryPayment::instance());
-            return;
-        }
-        else {
-            ++courier.curEdge_;
-            courier.fullDist_ = courier.calculateFullDistance();
-        }
+    if (courier.moveAlongRoute()) {
+        courier.status_ = CourierStatus::DELIVERY_AND_PAYMENT;
     }
-    courier.curLocation_ = courier.calculateCurrentLocation();
 }
 
-void CourierDeliveryPayment::update(Courier& courier, std::chrono::nanoseconds passedTime)
+void Courier::updateDeliveryPayment(Courier& courier, chrono::nanoseconds passedTime)
 {
     if (courier.prevStatus_ != CourierStatus::DELIVERY_AND_PAYMENT) {
         courier.prevStatus_ = CourierStatus::DELIVERY_AND_PAYMENT;
         courier.curLocation_ = courier.getLocation(courier.curEdge_->m_target);
         courier.makingTime_ = chrono::seconds{ cmn::getRandomNumber(
-            Options::instance().optCourier_.minDeliveryTime_,
-            Options::instance().optCourier_.deliveryTime_
+            OptionsCourier::minDeliveryTime_,
+            courier.ms_.options().optCourier_.deliveryTime_
         ) };
     }
     courier.passedTime_ += passedTime;
-    if (courier.passedTime_ >= courier.makingTime_) {
+    while (courier.passedTime_ >= courier.makingTime_) {
         courier.passedTime_ -= courier.makingTime_;
         if ((*courier.curOrder_)->isPaid() == true) {
             (*courier.curOrder_)->setStatus(OrderStatus::DELIVERING_COMPLETED);
             if (courier.curOrder_ == --courier.route_->getOrders().end()) {
                 assert(courier.curEdge_ == --courier.route_->getPath().cend());
-                this->changeState(courier, CourierReturning::instance());
+                courier.status_ = CourierStatus::RETURNING_TO_OFFICE;
                 return;
             }
             ++courier.curOrder_;
@@ -214,49 +280,46 @@ void CourierDeliveryPayment::update(Courier& courier, std::chrono::nanoseconds p
             }
             ++courier.curEdge_;
             assert(courier.curEdge_ != courier.route_->getPath().cend());
-            this->changeState(courier, CourierMovement::instance());
+            courier.status_ = CourierStatus::MOVEMENT_TO_CUSTOMER;
             return;
         }
         courier.makingTime_ = chrono::seconds{ cmn::getRandomNumber(
-            Options::instance().optCourier_.minPaymentTime_,
-            Options::instance().optCourier_.paymentTime_
+            OptionsCourier::minPaymentTime_,
+            courier.ms_.options().optCourier_.paymentTime_
         ) };
         (*courier.curOrder_)->setStatus(OrderStatus::PAYING);
         (*courier.curOrder_)->isPaid(true);
     }
 }
 
-void CourierReturning::update(Courier& courier, std::chrono::nanoseconds passedTime)
+void Courier::updateReturning(Courier& courier, chrono::nanoseconds passedTime)
 {
     if (courier.prevStatus_ != CourierStatus::RETURNING_TO_OFFICE) {
         courier.prevStatus_ = CourierStatus::RETURNING_TO_OFFICE;
         const auto source{ courier.curEdge_->m_target };
-        auto path{ courier.ms_.map().getPath(source, courier.ms_.scheduler().getOffice()) };
-        unique_ptr<Route> route{ new Route{ courier.ms_, vector<Order*>{}, std::move(path)}};
-        courier.route_ = std::move(route);
+        const auto path{ courier.ms_.paths().findPath(
+            source, courier.ms_.scheduler().getOffice(), courier.ms_.options()) };
+        assert(path != nullptr);
         courier.curOrder_ = vector<Order*>::iterator{};
+        if (path->empty()) {
+            // the last stop is the office, the courier waits for the next route there
+            courier.ms_.delivery().releaseRoute(courier.route_);
+            courier.curEdge_ = Courier::edge_const_iterator_t{};
+            courier.curLocation_ = courier.getOfficeLocation();
+            courier.passedTime_ += passedTime;
+            courier.status_ = CourierStatus::WAITING_FOR_NEXT;
+            return;
+        }
+        // the route of the delivered orders becomes the route back to the office
+        courier.route_->setPath(*path);
         courier.curEdge_ = courier.route_->getPath().cbegin();
         courier.passedDist_ = 0;
-        courier.fullDist_ = courier.calculateFullDistance();
-        courier.makingTime_ = chrono::nanoseconds{ 0 };
+        courier.fullDist_ = courier.route_->getDistances()[courier.getCurrentStop()] * nano::den;
     }
     courier.passedTime_ += passedTime;
-    courier.makingTime_ += passedTime;
-    courier.passedDist_ += passedTime.count() * Options::instance().optCourier_.averageSpeed_;
-    if (courier.passedDist_ >= courier.fullDist_) {
-        courier.passedDist_ -= courier.fullDist_;
-        if (courier.curEdge_ == --courier.route_->getPath().cend()) {
-            courier.curLocation_ = courier.getLocation(courier.curEdge_->m_target);
-            courier.passedTime_ -= courier.makingTime_;
-            this->changeState(courier, CourierInaccessible::instance());
-            return;
-        }
-        else {
-            ++courier.curEdge_;
-            courier.fullDist_ = courier.calculateFullDistance();
-        }
+    if (courier.moveAlongRoute()) {
+        courier.status_ = CourierStatus::INACCESSIBLE;
     }
-    courier.curLocation_ = courier.calculateCurrentLocation();
 }
 
 } // namespace ds
@@ -15,6 +15,7 @@
 #include<chrono>
 #include<limits>
 #include<memory>
+#include<string_view>
 #include<vector>
 
 namespace ds {
@@ -33,21 +34,20 @@ enum class CourierStatus : char {
     __END                           /// must be the last
 };
 
-std::string toString(CourierStatus value);
+std::string_view toString(CourierStatus value) noexcept;
 
 ///************************************************************************************************
 
+class Checkpoint;
+class Delivery;
 class ManagmentSystem;
 
+// Courier is a state machine dispatched on its status, the delivery updates
+// the couriers of the same status together in one batch
 class Courier {
 public:
-    friend class CourierState;
-    friend class CourierInaccessible;
-    friend class CourierWaiting;
-    friend class CourierAccepting;
-    friend class CourierMovement;
-    friend class CourierDeliveryPayment;
-    friend class CourierReturning;
+    friend Checkpoint;
+    friend Delivery;
 
 public:
     using edge_const_iterator_t = std::vector<Graph::edge_descriptor>::const_iterator;
@@ -61,9 +61,9 @@ public:
     virtual ~Courier() noexcept {}
 
 public:
-    virtual void update(std::chrono::nanoseconds passedTime);
+    void update(std::chrono::nanoseconds passedTime);
 
-    virtual CourierStatus getStatus() const noexcept;
+    CourierStatus getStatus() const noexcept { return status_; }
 
     WorkerID getID() const noexcept { return id_; }
 
@@ -75,157 +75,65 @@ public:
 
     const Route* getRoute() const { return route_.get(); }
 
+    std::chrono::nanoseconds getTimeToDeparture() const noexcept;
+
+    void insertOrder(size_t position, Order* order,
+        const std::vector<Graph::edge_descriptor>& pathTo,
+        const std::vector<Graph::edge_descriptor>& pathFrom);
+
 private:
     ImVec2 getLocation(size_t target) const;
 
-    ImVec2 calculateCurrentLocation();
+    ImVec2 calculateCurrentLocation() const;
 
     ImVec2 getOfficeLocation() const;
 
     static ImVec2 getInaccessibleLocation();
 
-    long long int calculateFullDistance() const;
-
-    void changeState(CourierState& state) { state_ = &state; }
-
-private:
-    CourierState*                               state_;
-    ManagmentSystem&                            ms_;
-    std::unique_ptr<Route>                      route_;
-    std::chrono::nanoseconds                    passedTime_;
-    std::chrono::nanoseconds                    makingTime_;
-    std::vector<Order*>::iterator               curOrder_;      // current order being delivered
-    edge_const_iterator_t                       curEdge_;       // current traversable edge on the path
-    long long int                               passedDist_;    // passed distance for current edge, nanometers
-    long long int                               fullDist_;      // full distance of current edge, nanometers
-    ImVec2                                      curLocation_;
-    WorkerID                                    id_;
-    CourierStatus                               prevStatus_;
-};
-
-///************************************************************************************************
-
-class CourierState {
-protected:
-    CourierState() noexcept {}
-
-public:
-    virtual void update(Courier& courier, std::chrono::nanoseconds passedTime);
-
-    virtual CourierStatus getStatus() const noexcept { return CourierStatus::__INVALID; }
-
-protected:
-    void changeState(Courier& courier, CourierState& state) { courier.changeState(state); }
-};
-
-
-class CourierInaccessible : public CourierState {
-protected:
-    CourierInaccessible() noexcept {}
-
-public:
-    static CourierInaccessible& instance() noexcept { return state_; }
-
-public:
-    virtual void update(Courier& courier, std::chrono::nanoseconds passedTime);
-
-    virtual CourierStatus getStatus() const noexcept { return CourierStatus::INACCESSIBLE; }
-
-private:
-    static CourierInaccessible state_;
-};
-
-
-class CourierWaiting : public CourierState {
-protected:
-    CourierWaiting() noexcept {}
-
-public:
-    static CourierWaiting& instance() noexcept { return state_; }
-
-public:
-    virtual void update(Courier& courier, std::chrono::nanoseconds passedTime);
-
-    virtual CourierStatus getStatus() const noexcept { return CourierStatus::WAITING_FOR_NEXT; }
-
-private:
-    static CourierWaiting state_;
-};
-
-
-class CourierAccepting : public CourierState {
-protected:
-    CourierAccepting() noexcept {}
-
-public:
-    static CourierAccepting& instance() noexcept { return state_; }
-
-public:
-    virtual void update(Courier& courier, std::chrono::nanoseconds passedTime);
-
-    virtual CourierStatus getStatus() const noexcept { return CourierStatus::ACCEPTING_ORDER; }
-
-private:
-    static CourierAccepting state_;
-};
-
-
-class CourierMovement : public CourierState {
-protected:
-    CourierMovement() noexcept {}
-
-public:
-    static CourierMovement& instance() noexcept { return state_; }
-
-public:
-    virtual void update(Courier& courier, std::chrono::nanoseconds passedTime);
-
-    virtual CourierStatus getStatus() const noexcept { return CourierStatus::MOVEMENT_TO_CUSTOMER; }
-
-private:
-    static CourierMovement state_;
-};
-
+    size_t getCurrentStop() const;
 
-class CourierDeliveryPayment : public CourierState {
-protected:
-    CourierDeliveryPayment() noexcept {}
+    edge_const_iterator_t findCurrentEdge() const;
 
-public:
-    static CourierDeliveryPayment& instance() noexcept { return state_; }
+    bool moveAlongRoute();
 
-public:
-    virtual void update(Courier& courier, std::chrono::nanoseconds passedTime);
+    void updateStatus(std::chrono::nanoseconds passedTime);
 
-    virtual CourierStatus getStatus() const noexcept { return CourierStatus::DELIVERY_AND_PAYMENT; }
+    static void updateInaccessible(Courier& courier, std::chrono::nanoseconds passedTime);
 
-private:
-    static CourierDeliveryPayment state_;
-};
+    static void updateWaiting(Courier& courier, std::chrono::nanoseconds passedTime);
 
+    static void updateAccepting(Courier& courier, std::chrono::nanoseconds passedTime);
 
-class CourierReturning : public CourierState {
-protected:
-    CourierReturning() noexcept {}
+    static void updateMovement(Courier& courier, std::chrono::nanoseconds passedTime);
 
-public:
-    static CourierReturning& instance() noexcept { return state_; }
+    static void updateDeliveryPayment(Courier& courier, std::chrono::nanoseconds passedTime);
 
-public:
-    virtual void update(Courier& courier, std::chrono::nanoseconds passedTime);
-
-    virtual CourierStatus getStatus() const noexcept { return CourierStatus::RETURNING_TO_OFFICE; }
+    static void updateReturning(Courier& courier, std::chrono::nanoseconds passedTime);
 
 private:
-    static CourierReturning state_;
+    ManagmentSystem&                            ms_;
+    std::unique_ptr<Route>                      route_;
+    std::chrono::nanoseconds                    passedTime_;
+    std::chrono::nanoseconds                    makingTime_;
+    std::vector<Order*>::iterator               curOrder_;      // current order being delivered
+    edge_const_iterator_t                       curEdge_;       // current traversable edge on the path
+    long long int                               passedDist_;    // passed distance from the start of the route, nanometers
+    long long int                               fullDist_;      // distance from the start of the route to the next stop, nanometers
+    ImVec2                                      curLocation_;
+    WorkerID                                    id_;
+    CourierStatus                               status_;        // current status
+    CourierStatus                               prevStatus_;    // status of the previous update, the status is entered if they differ
 };
 
 ///************************************************************************************************
 
 inline void Courier::update(std::chrono::nanoseconds passedTime)
 {
-    assert(state_);
-    return state_->update(*this, passedTime);
+    updateStatus(passedTime);
+    // the time left after changing the status is spent in the next status
+    while (prevStatus_ != status_) {
+        updateStatus(std::chrono::nanoseconds{ 0 });
+    }
 }
 
 inline ImVec2 Courier::getInaccessibleLocation()
@@ -236,17 +144,6 @@ inline ImVec2 Courier::getInaccessibleLocation()
     };
 }
 
-inline CourierStatus Courier::getStatus() const noexcept
-{
-    assert(state_);
-    return state_->getStatus();
-}
-
-inline void CourierState::update(Courier& courier, std::chrono::nanoseconds passedTime)
-{
-    courier.update(passedTime);
-}
-
 } // namespace ds
 
 #endif // !COURIER_HPP
@@ -14,7 +14,7 @@ namespace ds {
 
 using namespace std;
 
-string toString(KitchenerType value)
+string_view toString(KitchenerType value) noexcept
 {
     switch (value) {
     case KitchenerType::__INVALID:
@@ -31,7 +31,7 @@ string toString(KitchenerType value)
     static_assert(cmn::numberOf<KitchenerType>() == 3);
 }
 
-string toString(KitchenerStatus value)
+string_view toString(KitchenerStatus value) noexcept
 {
     switch (value) {
     case KitchenerStatus::__INVALID:
@@ -50,27 +50,21 @@ string toString(KitchenerStatus value)
 
 ///************************************************************************************************
 
-KitchenerInaccessible   KitchenerInaccessible::state_{};
-KitchenerWaiting        KitchenerWaiting::state_{};
-KitchenerMaking         KitchenerMaking::state_{};
-
-///************************************************************************************************
-
 Kitchener::Kitchener(ManagmentSystem& ms, WorkerID workerID, KitchenerType type)
     :
-    state_          { &KitchenerWaiting::instance() },
     ms_             { ms },
     food_           { nullptr },
     passedTime_     { 0 },
     makingTime_     { 0 },
     id_             { workerID },
     type_           { type },
+    status_         { KitchenerStatus::WAITING_FOR_NEXT },
     prevStatus_     { KitchenerStatus::__INVALID }
 {}
 
 ///************************************************************************************************
 
-void KitchenerInaccessible::update(Kitchener& kitchener, std::chrono::nanoseconds passedTime)
+void Kitchener::updateInaccessible(Kitchener& kitchener, chrono::nanoseconds passedTime)
 {
     assert(kitchener.food_ == nullptr);
     if (kitchener.prevStatus_ != KitchenerStatus::INACCESSIBLE) {
@@ -78,16 +72,20 @@ void KitchenerInaccessible::update(Kitchener& kitchener, std::chrono::nanosecond
         kitchener.makingTime_ = (random >= 1 && random <= Options::pauseChance_) ?
             chrono::seconds{ cmn::getRandomNumber(Options::minPauseTime_, Options::maxPauseTime_) } :
             chrono::seconds{ 5 };
+        // the pause is known now instead of the expected one
+        kitchener.ms_.kitchen().invalidatePlan(kitchener.getType());
     }
     kitchener.prevStatus_ = KitchenerStatus::INACCESSIBLE;
     kitchener.passedTime_ += passedTime;
     if (kitchener.passedTime_ >= kitchener.makingTime_) {
         kitchener.passedTime_ -= kitchener.makingTime_;
-        this->changeState(kitchener, KitchenerWaiting::instance());
+        kitchener.ms_.kitchen().pushIdleKitchener(&kitchener);
+        kitchener.ms_.kitchen().invalidatePlan(kitchener.getType());
+        kitchener.status_ = KitchenerStatus::WAITING_FOR_NEXT;
     }
 }
 
-void KitchenerWaiting::update(Kitchener& kitchener, std::chrono::nanoseconds passedTime)
+void Kitchener::updateWaiting(Kitchener& kitchener, chrono::nanoseconds passedTime)
 {
     if (kitchener.prevStatus_ != KitchenerStatus::WAITING_FOR_NEXT) {
         kitchener.makingTime_ = chrono::nanoseconds{ 0 };
@@ -97,15 +95,18 @@ void KitchenerWaiting::update(Kitchener& kitchener, std::chrono::nanoseconds pas
     kitchener.makingTime_ += passedTime;
     if (kitchener.food_ != nullptr) {
         kitchener.passedTime_ -= kitchener.makingTime_;
-        this->changeState(kitchener, KitchenerMaking::instance());
+        kitchener.status_ = KitchenerStatus::MAKING;
     }
 }
 
-void KitchenerMaking::update(Kitchener& kitchener, std::chrono::nanoseconds passedTime)
+void Kitchener::updateMaking(Kitchener& kitchener, chrono::nanoseconds passedTime)
 {
     assert(kitchener.food_ != nullptr);
     if (kitchener.prevStatus_ != KitchenerStatus::MAKING) {
-        kitchener.food_->setStatus(FoodStatus::MAKING);
+        kitchener.ms_.kitchen().traceStation(kitchener.food_,
+            Kitchen::getStationState(kitchener.getType(), false), Kitchen::getStationState(kitchener.getType(), true));
+        kitchener.ms_.kitchen().updateOrder(kitchener.food_, FoodStatus::MAKING);
+        kitchener.ms_.kitchen().invalidatePlan(kitchener.getType());
         switch (kitchener.getType()) {
         case KitchenerType::DOUGH:
             kitchener.makingTime_ = kitchener.food_->doughTime_;
@@ -136,15 +137,18 @@ void KitchenerMaking::update(Kitchener& kitchener, std::chrono::nanoseconds pass
             kitchener.ms_.kitchen().pushFrontQueuePicker(kitchener.food_);
             break;
         case KitchenerType::PICKER:
-            kitchener.food_->setStatus(FoodStatus::DONE);
+            kitchener.ms_.kitchen().traceStation(kitchener.food_,
+                Kitchen::getStationState(KitchenerType::PICKER, true), -1);
+            kitchener.ms_.kitchen().updateOrder(kitchener.food_, FoodStatus::DONE);
             break;
         default:
             assert(false);
             break;
         }
+        kitchener.ms_.kitchen().invalidatePlan(kitchener.getType());
         kitchener.food_ = nullptr;
         kitchener.passedTime_ -= kitchener.makingTime_;
-        this->changeState(kitchener, KitchenerInaccessible::instance());
+        kitchener.status_ = KitchenerStatus::INACCESSIBLE;
     }
 }
 
@@ -11,7 +11,7 @@
 #include"worker.hpp"
 #include<assert.h>
 #include<chrono>
-#include<string>
+#include<string_view>
 
 namespace ds {
 
@@ -37,20 +37,22 @@ enum class KitchenerStatus : char {
     __END                           /// must be the last
 };
 
-std::string toString(KitchenerType value);
+std::string_view toString(KitchenerType value) noexcept;
 
-std::string toString(KitchenerStatus value);
+std::string_view toString(KitchenerStatus value) noexcept;
 
 ///************************************************************************************************
 
+class Checkpoint;
+class Kitchen;
 class ManagmentSystem;
 
+// Kitchener is a state machine dispatched on its status, the kitchen updates
+// the kitcheners of the same status together in one batch
 class Kitchener {
 public:
-    friend class KitchenerState;
-    friend class KitchenerInaccessible;
-    friend class KitchenerWaiting;
-    friend class KitchenerMaking;
+    friend Checkpoint;
+    friend Kitchen;
 
 public:
     Kitchener(ManagmentSystem& ms, WorkerID workerID, KitchenerType type);
@@ -61,9 +63,9 @@ public:
     virtual ~Kitchener() noexcept {}
 
 public:
-    virtual void update(std::chrono::nanoseconds passedTime);
+    void update(std::chrono::nanoseconds passedTime);
 
-    virtual KitchenerStatus getStatus() const noexcept;
+    KitchenerStatus getStatus() const noexcept { return status_; }
 
     WorkerID getID() const noexcept { return id_; }
 
@@ -74,97 +76,41 @@ public:
     void makeFood(Food* food);
 
 private:
-    void changeState(KitchenerState& state) { state_ = &state; }
+    static void updateInaccessible(Kitchener& kitchener, std::chrono::nanoseconds passedTime);
+
+    static void updateWaiting(Kitchener& kitchener, std::chrono::nanoseconds passedTime);
+
+    static void updateMaking(Kitchener& kitchener, std::chrono::nanoseconds passedTime);
 
 private:
-    KitchenerState*                             state_;
     ManagmentSystem&                            ms_;
     Food*                                       food_;
     std::chrono::nanoseconds                    passedTime_;
     std::chrono::nanoseconds                    makingTime_;
     const WorkerID                              id_;
     const KitchenerType                         type_;
-    KitchenerStatus                             prevStatus_;
-};
-
-///************************************************************************************************
-
-class KitchenerState {
-protected:
-    KitchenerState() noexcept {}
-
-public:
-    virtual void update(Kitchener& kitchener, std::chrono::nanoseconds passedTime);
-
-    virtual KitchenerStatus getStatus() const noexcept { return KitchenerStatus::__INVALID; }
-
-protected:
-    void changeState(Kitchener& kitchener, KitchenerState& state) { kitchener.changeState(state); }
-};
-
-
-class KitchenerInaccessible : public KitchenerState {
-protected:
-    KitchenerInaccessible() noexcept {}
-
-public:
-    static KitchenerInaccessible& instance() noexcept { return state_; }
-
-public:
-    virtual void update(Kitchener& kitchener, std::chrono::nanoseconds passedTime);
-
-    virtual KitchenerStatus getStatus() const noexcept { return KitchenerStatus::INACCESSIBLE; }
-
-private:
-    static KitchenerInaccessible state_;
-};
-
-
-class KitchenerWaiting : public KitchenerState {
-protected:
-    KitchenerWaiting() noexcept {}
-
-public:
-    static KitchenerWaiting& instance() noexcept { return state_; }
-
-public:
-    virtual void update(Kitchener& kitchener, std::chrono::nanoseconds passedTime);
-
-    virtual KitchenerStatus getStatus() const noexcept { return KitchenerStatus::WAITING_FOR_NEXT; }
-
-private:
-    static KitchenerWaiting state_;
-};
-
-
-class KitchenerMaking : public KitchenerState {
-protected:
-    KitchenerMaking() noexcept {}
-
-public:
-    static KitchenerMaking& instance() noexcept { return state_; }
-
-public:
-    virtual void update(Kitchener& kitchener, std::chrono::nanoseconds passedTime);
-
-    virtual KitchenerStatus getStatus() const noexcept { return KitchenerStatus::MAKING; }
-
-private:
-    static KitchenerMaking state_;
+    KitchenerStatus                             status_;        // current status
+    KitchenerStatus                             prevStatus_;    // status of the previous update, the status is entered if they differ
 };
 
 ///************************************************************************************************
 
 inline void Kitchener::update(std::chrono::nanoseconds passedTime)
 {
-    assert(state_);
-    return state_->update(*this, passedTime);
-}
-
-inline KitchenerStatus Kitchener::getStatus() const noexcept
-{
-    assert(state_);
-    return state_->getStatus();
+    switch (status_) {
+    case KitchenerStatus::INACCESSIBLE:
+        updateInaccessible(*this, passedTime);
+        break;
+    case KitchenerStatus::WAITING_FOR_NEXT:
+        updateWaiting(*this, passedTime);
+        break;
+    case KitchenerStatus::MAKING:
+        updateMaking(*this, passedTime);
+        break;
+    default:
+        assert(false);
+        break;
+    }
 }
 
 inline void Kitchener::makeFood(Food* food)
@@ -173,11 +119,6 @@ inline void Kitchener::makeFood(Food* food)
     food_ = food;
 }
 
-inline void KitchenerState::update(Kitchener& kitchener, std::chrono::nanoseconds passedTime)
-{
-    assert(false);
-}
-
 } // namespace ds
 
 #endif // !KITCHENER_HPP
@@ -0,0 +1,53 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"allocation.hpp"
+#include"common.hpp"
+#include"generator.hpp"
+#include"msystem.hpp"
+#include"options.hpp"
+#include"simulation.hpp"
+#include<gtest/gtest.h>
+#include<chrono>
+
+using namespace std::chrono_literals;
+
+// the same check as 'pizza-ds-bench check=1': after the warm-up the updates without
+// an arrival and without a route search do not allocate; the search allocates its labels
+// and its result, the routes of the couriers are reused
+TEST(Allocation, UpdatesWithoutArrivalsAndRouteSearchesDoNotAllocate)
+{
+    if (cmn::isAllocationCounted == false) {
+        GTEST_SKIP() << u8"the allocations are counted only in the builds with DS_COUNT_ALLOCATIONS";
+    }
+    ds::OptionsSimulation options{};
+    options.optGenerator_.orderRate_ = 30;
+    bench::Simulation simulation{ 0, options };
+    ds::ManagmentSystem& ms{ simulation.ms_ };
+    const ds::Map& map{ *simulation.map_ };
+    const ds::Delivery& delivery{ simulation.delivery_ };
+    cmn::seedRandomNumbers(1);
+    bench::staff(ms, 2, 3, 4, 3);
+    ds::OrderGenerator generator{ ms, 1 };
+
+    const std::chrono::nanoseconds step{ 16ms };
+    unsigned long long int steadyUpdates{ 0 };
+    for (std::chrono::nanoseconds time{ 0 }; time < 3h; time += step) {
+        generator.update(step);
+        const size_t orders{ ms.orderTable().size() };
+        const unsigned long long int searches{ map.getNumberOfSearches() };
+        const unsigned long long int routed{ delivery.getNumberOfRoutedOrders() };
+        ms.update(step);
+        if (time >= 1h
+            && orders == ms.orderTable().size()
+            && searches == map.getNumberOfSearches()
+            && routed == delivery.getNumberOfRoutedOrders())
+        {
+            ASSERT_EQ(ms.getAllocations(), 0u) << u8"at " << time.count() << u8" ns";
+            ++steadyUpdates;
+        }
+    }
+    EXPECT_GT(steadyUpdates, 0u);
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"checkpoint.hpp"
+#include"common.hpp"
+#include"eventlog.hpp"
+#include"generator.hpp"
+#include"msystem.hpp"
+#include"options.hpp"
+#include"simulation.hpp"
+#include<gtest/gtest.h>
+#include<chrono>
+#include<cstdio>
+#include<string>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+const std::chrono::nanoseconds step{ 250ms };
+
+// the orders after the checkpoint come from a new generator, its state is not saved
+void runAfterCheckpoint(ds::ManagmentSystem& ms)
+{
+    ds::OrderGenerator generator{ ms, 2 };
+    generator.setTime(ms.getCurrentTick());
+    for (std::chrono::nanoseconds time{ 0 }; time < 1h; time += step) {
+        generator.update(step);
+        ms.update(step);
+    }
+}
+
+} // namespace
+
+// the restored system has the state of the saved one and goes on as it does
+TEST(Checkpoint, RestoredSystemGoesOnAsSavedOne)
+{
+    const std::string fileName{ testing::TempDir() + u8"pizza-ds-checkpoint-test.ckpt" };
+    ds::OptionsSimulation options{};
+    options.optGenerator_.orderRate_ = 40;
+    unsigned long long int savedHash{ 0 };
+    unsigned long long int finalHash{ 0 };
+    {
+        bench::Simulation simulation{ 0, options };
+        ds::ManagmentSystem& ms{ simulation.ms_ };
+        cmn::seedRandomNumbers(1);
+        bench::staff(ms, 2, 2, 3, 4);
+        ds::OrderGenerator generator{ ms, 1 };
+        for (std::chrono::nanoseconds time{ 0 }; time < 2h; time += step) {
+            generator.update(step);
+            ms.update(step);
+        }
+        ASSERT_TRUE(ds::Checkpoint::write(ms, fileName));
+        savedHash = ds::hashState(ms);
+        runAfterCheckpoint(ms);
+        finalHash = ds::hashState(ms);
+    }
+
+    // the random numbers of the restored system go on from the checkpoint
+    cmn::seedRandomNumbers(2);
+    bench::Simulation simulation{ 0, options };
+    ds::ManagmentSystem& ms{ simulation.ms_ };
+    ASSERT_TRUE(ds::Checkpoint::restore(ms, fileName));
+    std::remove(fileName.c_str());
+    EXPECT_GT(ms.orderTable().size(), 0u);
+    EXPECT_EQ(ds::hashState(ms), savedHash);
+    runAfterCheckpoint(ms);
+    EXPECT_EQ(ds::hashState(ms), finalHash);
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"common.hpp"
+#include"courier.hpp"
+#include"msystem.hpp"
+#include"options.hpp"
+#include"order.hpp"
+#include"simulation.hpp"
+#include<gtest/gtest.h>
+#include<chrono>
+#include<memory>
+#include<vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct CourierState {
+    ds::CourierStatus                           status_;
+    float                                       x_;
+    float                                       y_;
+    size_t                                      order_;         // position of the current order in the route
+};
+
+// the courier takes the route through two far corners of the grid and is updated
+// 'numSteps' times by 'step' between the recorded states
+std::vector<CourierState> driveCourier(std::chrono::nanoseconds step, size_t numSteps)
+{
+    constexpr size_t grid{ 15 };
+    ds::OptionsSimulation options{};
+    bench::Simulation simulation{ grid, options };
+    ds::ManagmentSystem& ms{ simulation.ms_ };
+    cmn::seedRandomNumbers(1);
+
+    const size_t office{ simulation.scheduler_.getOffice() };
+    const size_t targets[]{ 0, grid * grid - 1 };
+    std::vector<ds::Order*> orders{};
+    std::vector<ds::Graph::edge_descriptor> path{};
+    size_t source{ office };
+    for (const size_t target : targets) {
+        orders.push_back(ms.createOrder(target));
+        const auto part{ ms.paths().findPath(source, target, ms.options()) };
+        EXPECT_NE(part, nullptr);
+        path.insert(path.end(), part->cbegin(), part->cend());
+        source = target;
+    }
+    ds::Courier courier{ ms, ds::WorkerID{ 0 } };
+    std::unique_ptr<ds::Route> route{ new ds::Route{ *simulation.map_, orders, path } };
+    courier.setRoute(route);
+    // the courier takes the route at once, the time of the steps is spent on the route
+    courier.update(std::chrono::nanoseconds{ 0 });
+
+    std::vector<CourierState> states{};
+    for (int i = 0; i < 16; ++i) {
+        for (size_t s = 0; s < numSteps; ++s) {
+            courier.update(step);
+        }
+        const ImVec2 location{ courier.getCurrentLocation() };
+        const bool isDelivering{ courier.getRoute() != nullptr
+            && courier.getRoute()->getOrders().empty() == false };
+        states.push_back(CourierState{ courier.getStatus(), location.x, location.y,
+            isDelivering ? size_t(courier.getCurrentOrder() - courier.getRoute()->getOrders().begin()) : 0 });
+    }
+    return states;
+}
+
+} // namespace
+
+// a step may cross any number of edges and stops, so the courier is at the same place
+// after one long step as after the many short steps of the same time
+TEST(Courier, LongStepEndsWhereShortStepsEnd)
+{
+    const std::vector<CourierState> longSteps{ driveCourier(100s, 1) };
+    const std::vector<CourierState> shortSteps{ driveCourier(16ms, 6250) };
+    ASSERT_EQ(longSteps.size(), shortSteps.size());
+    bool isMoving{ false };
+    for (size_t i = 0; i < longSteps.size(); ++i) {
+        EXPECT_EQ(longSteps[i].status_, shortSteps[i].status_) << u8"at " << (i + 1) * 100 << u8" s";
+        EXPECT_EQ(longSteps[i].x_, shortSteps[i].x_) << u8"at " << (i + 1) * 100 << u8" s";
+        EXPECT_EQ(longSteps[i].y_, shortSteps[i].y_) << u8"at " << (i + 1) * 100 << u8" s";
+        EXPECT_EQ(longSteps[i].order_, shortSteps[i].order_) << u8"at " << (i + 1) * 100 << u8" s";
+        isMoving = isMoving || longSteps[i].status_ == ds::CourierStatus::MOVEMENT_TO_CUSTOMER;
+    }
+    EXPECT_TRUE(isMoving);
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"common.hpp"
+#include"delivery.hpp"
+#include"generator.hpp"
+#include"msystem.hpp"
+#include"options.hpp"
+#include"simulation.hpp"
+#include<gtest/gtest.h>
+#include<algorithm>
+#include<chrono>
+
+using namespace std::chrono_literals;
+
+// the orders are pushed by the kitchen, taken by the routes, inserted late into the routes
+// and their deadlines move with the delivery time, the queue stays a min-heap on the deadline
+TEST(Delivery, QueueIsMinHeapOnDeadline)
+{
+    ds::OptionsSimulation options{};
+    options.optGenerator_.orderRate_ = 60;
+    options.optDelivery_.lateInsertion_ = true;
+    bench::Simulation simulation{ 0, options };
+    ds::ManagmentSystem& ms{ simulation.ms_ };
+    const ds::Delivery& delivery{ simulation.delivery_ };
+    cmn::seedRandomNumbers(1);
+    bench::staff(ms, 2, 3, 4, 2);
+    ds::OrderGenerator generator{ ms, 1 };
+
+    const std::chrono::nanoseconds step{ 1s };
+    const std::chrono::nanoseconds changeTime{ 2h };
+    size_t maxQueue{ 0 };
+    for (std::chrono::nanoseconds time{ 0 }; time < 4h; time += step) {
+        if (time == changeTime) {
+            options.optDelivery_.deliveryTime_ -= 60 * 10;
+            ms.setOptions(options);
+        }
+        generator.update(step);
+        ms.update(step);
+
+        const auto [order, orderEnd]{ delivery.getQueue() };
+        const auto [target, targetEnd]{ delivery.getQueueTargets() };
+        const size_t size( orderEnd - order );
+        ASSERT_EQ(size, size_t(targetEnd - target));
+        maxQueue = std::max(maxQueue, size);
+        auto getDeliveryTime{ [&](size_t i) {
+            return target[i].deadline_ - order[i]->getTimeStart() / cmn::ticksPerSecond;
+        } };
+        for (size_t i = 0; i < size; ++i) {
+            ASSERT_EQ(target[i].vertex_, order[i]->getTarget());
+            ASSERT_EQ(getDeliveryTime(i), getDeliveryTime(0))
+                << u8"the deadlines moved apart at " << time.count() << u8" ns";
+            if (i > 0) {
+                ASSERT_LE(target[(i - 1) / 2].deadline_, target[i].deadline_)
+                    << u8"not a heap at " << time.count() << u8" ns";
+            }
+        }
+        // the deadlines follow the delivery time at the next dispatch after its change
+        if (size > 0 && (time < changeTime || time >= changeTime + 2 * step)) {
+            EXPECT_EQ(getDeliveryTime(0), options.optDelivery_.deliveryTime_);
+        }
+    }
+    EXPECT_GT(maxQueue, 1u);
+    EXPECT_GT(delivery.getNumberOfRoutedOrders(), 0u);
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"common.hpp"
+#include"eventlog.hpp"
+#include"generator.hpp"
+#include"msystem.hpp"
+#include"options.hpp"
+#include"simulation.hpp"
+#include<gtest/gtest.h>
+#include<chrono>
+#include<cstdio>
+#include<string>
+
+using namespace std::chrono_literals;
+
+// the replay of the recorded inputs, including a change of the options and of the staff,
+// ends in the recorded state
+TEST(EventLog, ReplayEndsInRecordedState)
+{
+    const std::string fileName{ testing::TempDir() + u8"pizza-ds-eventlog-test.events" };
+    ds::OptionsSimulation options{};
+    options.optGenerator_.orderRate_ = 40;
+    bench::Simulation simulation{ 0, options };
+    ds::ManagmentSystem& ms{ simulation.ms_ };
+    cmn::seedRandomNumbers(1);
+    ds::EventLog eventLog{ fileName };
+    ASSERT_TRUE(eventLog.isOpen());
+    ms.setEventLog(&eventLog);
+    bench::staff(ms, 2, 2, 3, 4);
+    ds::OrderGenerator generator{ ms, 1 };
+
+    const std::chrono::nanoseconds step{ 250ms };
+    for (std::chrono::nanoseconds time{ 0 }; time < 2h; time += step) {
+        if (time == 1h) {
+            options.optCourier_.averageSpeed_ += 2;
+            ms.setOptions(options);
+            ms.activateCourier(ds::WorkerID{ 100 });
+        }
+        generator.update(step);
+        ms.update(step);
+    }
+    ms.setEventLog(nullptr);
+    ASSERT_TRUE(eventLog.finish(ms));
+
+    ds::ReplayResult result{};
+    const bool isReplayed{ ds::replayEventLog(fileName, result) };
+    std::remove(fileName.c_str());
+    ASSERT_TRUE(isReplayed) << result.error_;
+    EXPECT_TRUE(result.isComplete_);
+    EXPECT_EQ(result.orders_, ms.orderTable().size());
+    EXPECT_GT(result.orders_, 0u);
+    EXPECT_EQ(result.hash_, result.recordedHash_);
+    EXPECT_EQ(result.hash_, ds::hashState(ms));
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"format.hpp"
+#include<gtest/gtest.h>
+#include<chrono>
+#include<cstring>
+#include<string_view>
+
+using namespace std::chrono_literals;
+
+// the numbers are padded on the left, the durations are "h:mm:ss" with unlimited hours
+TEST(TextBuffer, FormatsNumbersAndDurations)
+{
+    cmn::TextBuffer<64> text{};
+    text.append(u8"order ").append(42, 5, '0').append(' ').append(-7, 4).append(u8" ").append(2.5);
+    EXPECT_EQ(text.view(), std::string_view{ u8"order 00042   -7 2.5" });
+    EXPECT_EQ(std::strlen(text.c_str()), text.size());
+    // a number wider than 'width' is not cut
+    text.clear().append(123456, 3);
+    EXPECT_EQ(text.view(), std::string_view{ u8"123456" });
+
+    text.clear().appendDuration(0s);
+    EXPECT_EQ(text.view(), std::string_view{ u8"0:00:00" });
+    text.clear().appendDuration(27h + 3min + 5s + 900ms);
+    EXPECT_EQ(text.view(), std::string_view{ u8"27:03:05" });
+}
+
+// the text that does not fit is cut and the buffer stays terminated
+TEST(TextBuffer, CutsTextThatDoesNotFit)
+{
+    cmn::TextBuffer<8> text{};
+    text.append(u8"abcdef").append(12345);
+    EXPECT_EQ(text.view(), std::string_view{ u8"abcdef1" });
+    EXPECT_EQ(text.size(), 7u);
+    EXPECT_EQ(text.c_str()[7], '\0');
+    text.append('x').append(u8"yz").appendDuration(1h);
+    EXPECT_EQ(text.view(), std::string_view{ u8"abcdef1" });
+
+    // the filler is cut as well
+    text.clear().append(u8"ab").append(1, 10, '.');
+    EXPECT_EQ(text.view(), std::string_view{ u8"ab....." });
+    EXPECT_EQ(std::strlen(text.c_str()), text.size());
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"histogram.hpp"
+#include<gtest/gtest.h>
+#include<algorithm>
+#include<cmath>
+#include<random>
+#include<vector>
+
+namespace {
+
+// the exact percentile of the sorted values, the smallest value not exceeded by 'percentile' percents of them
+unsigned long long int getExactPercentile(const std::vector<unsigned long long int>& sorted, double percentile)
+{
+    const size_t rank{ size_t(std::ceil(percentile / 100.0 * sorted.size())) };
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+} // namespace
+
+// the values spread over many powers of two, each percentile is not less than the exact one
+// and differs from it by less than 1%
+TEST(Histogram, PercentilesWithinOnePercent)
+{
+    std::mt19937_64 engine{ 1 };
+    std::lognormal_distribution<double> distribution{ 10.0, 3.0 };
+    std::vector<unsigned long long int> values{};
+    cmn::Histogram histogram{};
+    for (int i = 0; i < 100000; ++i) {
+        const unsigned long long int value{ (unsigned long long int)std::min(distribution(engine), 1e15) };
+        values.push_back(value);
+        histogram.add(value);
+    }
+    std::sort(values.begin(), values.end());
+
+    EXPECT_EQ(histogram.getCount(), values.size());
+    EXPECT_EQ(histogram.getMin(), values.front());
+    EXPECT_EQ(histogram.getMax(), values.back());
+    for (const double percentile : { 0.1, 1.0, 10.0, 25.0, 50.0, 75.0, 90.0, 99.0, 99.9, 99.99, 100.0 }) {
+        const unsigned long long int exact{ getExactPercentile(values, percentile) };
+        const unsigned long long int value{ histogram.getPercentile(percentile) };
+        EXPECT_GE(value, exact) << percentile << u8" %";
+        EXPECT_LE(double(value - exact), exact * 0.01) << percentile << u8" %";
+    }
+}
+
+// the small values are counted exactly and the merged histogram is that of all the values
+TEST(Histogram, SmallValuesExactAndMerge)
+{
+    cmn::Histogram first{};
+    cmn::Histogram second{};
+    for (unsigned long long int value = 0; value < 256; ++value) {
+        (value % 2 == 0 ? first : second).add(value);
+    }
+    first.merge(second);
+    EXPECT_EQ(first.getCount(), 256u);
+    for (unsigned long long int value = 1; value <= 256; ++value) {
+        EXPECT_EQ(first.getPercentile(value * 100.0 / 256), value - 1);
+    }
+    first.reset();
+    EXPECT_EQ(first.getCount(), 0u);
+    EXPECT_EQ(first.getPercentile(50.0), 0u);
+}
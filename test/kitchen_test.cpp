@@ -0,0 +1,49 @@
+// Copyright (c) 2023 Vitaly Dikov
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"common.hpp"
+#include"generator.hpp"
+#include"kitchen.hpp"
+#include"msystem.hpp"
+#include"options.hpp"
+#include"simulation.hpp"
+#include<gtest/gtest.h>
+#include<chrono>
+#include<vector>
+
+using namespace std::chrono_literals;
+
+// the updates plan again only the changed stations, the ready times are the same as of the whole plan
+TEST(Kitchen, IncrementalReadyTimesEqualFullPlan)
+{
+    ds::OptionsSimulation options{};
+    options.optGenerator_.orderRate_ = 40;
+    bench::Simulation simulation{ 0, options };
+    ds::ManagmentSystem& ms{ simulation.ms_ };
+    ds::Kitchen& kitchen{ simulation.kitchen_ };
+    cmn::seedRandomNumbers(1);
+    bench::staff(ms, 2, 2, 3, 4);
+    ds::OrderGenerator generator{ ms, 1 };
+
+    const std::chrono::nanoseconds step{ 250ms };
+    std::vector<cmn::tick_t> readyTimes{};
+    size_t checkedOrders{ 0 };
+    for (std::chrono::nanoseconds time{ 0 }; time < 3h; time += step) {
+        generator.update(step);
+        ms.update(step);
+        readyTimes.clear();
+        const auto orders{ kitchen.getOrders() };
+        for (auto order = orders.first; order != orders.second; ++order) {
+            readyTimes.push_back((*order)->getReadyTime());
+        }
+        kitchen.recomputePlan();
+        for (auto order = orders.first; order != orders.second; ++order) {
+            ASSERT_EQ((*order)->getReadyTime(), readyTimes[size_t(order - orders.first)])
+                << u8"order " << cmn::toUnderlying((*order)->getID()) << u8" at " << time.count() << u8" ns";
+        }
+        checkedOrders += readyTimes.size();
+    }
+    EXPECT_GT(checkedOrders, 0u);
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"map.hpp"
+#include"msystem.hpp"
+#include"network.hpp"
+#include"options.hpp"
+#include"order.hpp"
+#include<gtest/gtest.h>
+#include<chrono>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+void staffOffices(ds::OfficeNetwork& network)
+{
+    for (size_t o = 0; o < network.getNumberOfOffices(); ++o) {
+        ds::ManagmentSystem& ms{ network.office(o) };
+        unsigned int id{ 0 };
+        for (const auto type : { ds::KitchenerType::DOUGH, ds::KitchenerType::FILLING, ds::KitchenerType::PICKER }) {
+            ms.activateKitchener(ds::WorkerID{ id++ }, type);
+            ms.activateKitchener(ds::WorkerID{ id++ }, type);
+        }
+        ms.activateCourier(ds::WorkerID{ id++ });
+        ms.activateCourier(ds::WorkerID{ id++ });
+    }
+}
+
+} // namespace
+
+TEST(OfficeNetwork, NearestOfficeFollowsEditsOfTheMap)
+{
+    // 0 - 1 - 2, both offices are as far from the vertex between them
+    ds::Map map{ 3, 1, 20 };
+    ds::OfficeNetwork network{ map, { 0, 2 }, ds::OptionsSimulation{} };
+    network.setSelection(ds::OfficeSelection::NEAREST);
+    EXPECT_EQ(network.selectOffice(1), 0u);
+
+    // the longer edge keeps the number of the vertices and the edges
+    map.removeEdge(0, 1);
+    map.addEdge(0, 1, 10'000);
+    EXPECT_EQ(network.selectOffice(1), 1u);
+
+    map.removeEdge(2, 1);
+    map.addEdge(2, 1, 100'000);
+    EXPECT_EQ(network.selectOffice(1), 0u);
+}
+
+TEST(OfficeNetwork, OfficesCompleteTheirOrdersInParallel)
+{
+    ds::Map map{};
+    ds::OfficeNetwork network{ map, { 0, 2, 1 }, ds::OptionsSimulation{} };
+    network.setSelection(ds::OfficeSelection::LEAST_LOADED);
+    staffOffices(network);
+
+    // the updates of the offices other than the first one run on the threads of the network
+    std::chrono::nanoseconds sinceOrder{ 0 };
+    for (std::chrono::nanoseconds time{ 0 }; time < 4h; time += 1s, sinceOrder += 1s) {
+        if (time < 2h && sinceOrder >= 5min) {
+            sinceOrder -= 5min;
+            ASSERT_NE(network.createOrder(), nullptr);
+        }
+        network.update(1s);
+    }
+
+    for (size_t o = 0; o < network.getNumberOfOffices(); ++o) {
+        const ds::ManagmentSystem& ms{ network.office(o) };
+        const auto orders{ ms.getOrders() };
+        ASSERT_NE(orders.first, orders.second) << u8"office " << o;
+        for (auto order = orders.first; order != orders.second; ++order) {
+            // the identifiers of the offices are interleaved, so they are unique in the network
+            EXPECT_EQ(static_cast<size_t>((*order)->getID()) % network.getNumberOfOffices(), o);
+            EXPECT_EQ((*order)->getStatus(), ds::OrderStatus::COMPLETED) << u8"office " << o;
+        }
+    }
+}
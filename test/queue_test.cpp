@@ -0,0 +1,58 @@
+// Copyright (c) 2023 Vitaly Dikov
+// 
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE or copy at https://www.boost.org/LICENSE_1_0.txt)
+
+#include"queue.hpp"
+#include<gtest/gtest.h>
+#include<thread>
+#include<utility>
+#include<vector>
+
+// the queue is small, so the producers find it full and wait for the consumer;
+// every value comes once and the values of each producer come in the order of their pushes
+TEST(MPSCQueue, SeveralProducersOneConsumer)
+{
+    constexpr unsigned int numProducers{ 4 };
+    constexpr unsigned int numValues{ 100000 };            // of each producer
+    cmn::MPSCQueue<std::pair<unsigned int, unsigned int>> queue{ 64 };
+    ASSERT_EQ(queue.getCapacity(), 64u);
+
+    std::vector<std::thread> producers{};
+    for (unsigned int p = 0; p < numProducers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (unsigned int i = 0; i < numValues; ++i) {
+                while (queue.push(std::pair{ p, i }) == false) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::vector<unsigned int> nextValue(numProducers, 0);
+    unsigned long long int popped{ 0 };
+    bool isOrdered{ true };
+    while (popped < numProducers * numValues) {
+        std::pair<unsigned int, unsigned int> value{};
+        if (queue.pop(value) == false) {
+            std::this_thread::yield();
+            continue;
+        }
+        // the queue is drained even after a wrong value, so the producers always finish
+        ++popped;
+        if (value.first >= numProducers) {
+            isOrdered = false;
+            continue;
+        }
+        isOrdered = isOrdered && value.second == nextValue[value.first];
+        nextValue[value.first] = value.second + 1;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(isOrdered);
+    for (unsigned int p = 0; p < numProducers; ++p) {
+        EXPECT_EQ(nextValue[p], numValues) << u8"producer " << p;
+    }
+    std::pair<unsigned int, unsigned int> value{};
+    EXPECT_FALSE(queue.pop(value));
+}